@@ -55,6 +55,16 @@ module pulpissimo #(
 `else
    // Reference clock for clock internal clock generation
   inout wire               pad_ref_clk,
+`endif
+  // Simulation builds (e.g. the Verilator harness closing the loop with a
+  // motor model) can define ACTUATOR_PORTS to get a custom_actuator_ctrl on
+  // the chip control bus with its signals exported as top-level ports.
+`ifdef ACTUATOR_PORTS
+  output logic [15:0]      actuator_pwm_o,
+  output logic             actuator_dir_o,
+  output logic             actuator_enable_o,
+  input  logic [15:0]      sensor_feedback_i,
+  output logic             actuator_irq_o,
 `endif
   // Active-low Asynchronous hard-reset
   inout wire               pad_reset_n,
@@ -263,6 +273,7 @@ module pulpissimo #(
   // Demultiplex the APB bus to 2 regions
   // - Clock Control
   // - Pad Multiplexer Control
+  // and, with ACTUATOR_PORTS, a third one for custom_actuator_ctrl
 
   typedef logic [31:0] addr_t;
   typedef logic [31:0] data_t;
@@ -273,14 +284,21 @@ module pulpissimo #(
     addr_t end_addr;
   } addr_rule_t;
 
+`ifdef ACTUATOR_PORTS
+  localparam int unsigned N_CHIP_CTRL_DEMUX_SLAVES = 3;
+`else
   localparam int unsigned N_CHIP_CTRL_DEMUX_SLAVES = 2;
-  localparam int unsigned APB_DEMUX_SELECT_WIDTH = $clog2(N_CHIP_CTRL_DEMUX_SLAVES);
+`endif
+  localparam int unsigned APB_DEMUX_SELECT_WIDTH = $clog2(N_CHIP_CTRL_DEMUX_SLAVES+1);
   localparam addr_rule_t[N_CHIP_CTRL_DEMUX_SLAVES-1:0] APB_DEMUX_ADDR_RULES = '{
+`ifdef ACTUATOR_PORTS
+       '{ idx: 3, start_addr: `SOC_MEM_MAP_CHIP_CTRL_ACTUATOR_START_ADDR, end_addr: `SOC_MEM_MAP_CHIP_CTRL_ACTUATOR_END_ADDR},
+`endif
        '{ idx: 1, start_addr: `SOC_MEM_MAP_CHIP_CTRL_FLL_START_ADDR, end_addr: `SOC_MEM_MAP_CHIP_CTRL_FLL_END_ADDR},
        '{ idx: 2, start_addr: `SOC_MEM_MAP_CHIP_CTRL_PAD_CFG_START_ADDR, end_addr: `SOC_MEM_MAP_CHIP_CTRL_PAD_CFG_END_ADDR}
   };
 
-  logic [N_CHIP_CTRL_DEMUX_SLAVES-1:0] s_apb_demux_sel;
+  logic [APB_DEMUX_SELECT_WIDTH-1:0] s_apb_demux_sel;
   APB #(.ADDR_WIDTH(32), .DATA_WIDTH(32)) s_apb_demuxed[N_CHIP_CTRL_DEMUX_SLAVES:0](); // +1 for error responses
 
   addr_decode #(
@@ -318,6 +336,32 @@ module pulpissimo #(
   `APB_ASSIGN(s_apb_fll_ctrl_bus, s_apb_demuxed[1])
   `APB_ASSIGN(s_apb_pads_ctrl_bus, s_apb_demuxed[2])
 
+`ifdef ACTUATOR_PORTS
+  //////////////////////////////
+  // Custom Actuator (sim I/O) //
+  //////////////////////////////
+  // interrupt_o only reaches the actuator_irq_o port: the FC interrupt
+  // controller lives in pulp_soc, which has no free event input for it.
+  // Firmware polls STATUS_REG instead.
+  custom_actuator_ctrl i_custom_actuator (
+    .clk_i             ( s_soc_clk                 ),
+    .rst_ni            ( s_soc_rstn_synced         ),
+    .psel_i            ( s_apb_demuxed[3].psel     ),
+    .penable_i         ( s_apb_demuxed[3].penable  ),
+    .pwrite_i          ( s_apb_demuxed[3].pwrite   ),
+    .paddr_i           ( s_apb_demuxed[3].paddr    ),
+    .pwdata_i          ( s_apb_demuxed[3].pwdata   ),
+    .prdata_o          ( s_apb_demuxed[3].prdata   ),
+    .pready_o          ( s_apb_demuxed[3].pready   ),
+    .pslverr_o         ( s_apb_demuxed[3].pslverr  ),
+    .actuator_pwm_o    ( actuator_pwm_o            ),
+    .actuator_dir_o    ( actuator_dir_o            ),
+    .actuator_enable_o ( actuator_enable_o         ),
+    .sensor_feedback_i ( sensor_feedback_i         ),
+    .interrupt_o       ( actuator_irq_o            )
+  );
+`endif
+
   /////////////////////
   // Pad Multiplexer //
   /////////////////////
@@ -61,6 +61,7 @@ echo ""
 echo "To run benchmarks with Verilator:"
 echo "  1. Build RTL: cd ../.. && make build (in target/sim/verilator)"
 echo "  2. Run: cd target/sim/verilator && make run_sim EXECUTABLE_PATH=$(pwd)/motor_control_baseline_O2.elf"
+echo "  3. Or run all of them in parallel: cd target/sim/verilator && make regression REGRESSION_ELFS=\"'$(pwd)/*.elf'\""
 echo ""
 echo "To analyze code size:"
 echo "  riscv32-unknown-elf-size *.elf"
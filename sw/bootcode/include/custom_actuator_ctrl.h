@@ -22,7 +22,12 @@
 //-----------------------------------------------------------------------------
 // Base Address
 //-----------------------------------------------------------------------------
+// Peripheral bus slot; builds of pulpissimo with ACTUATOR_PORTS (Verilator
+// VERILATOR_ACTUATOR=1) have the controller on the chip control bus instead:
+// compile with -DCUSTOM_ACTUATOR_BASE_ADDR=0x1A122000
+#ifndef CUSTOM_ACTUATOR_BASE_ADDR
 #define CUSTOM_ACTUATOR_BASE_ADDR  0x1A10D000
+#endif
 
 //-----------------------------------------------------------------------------
 // Register Offsets
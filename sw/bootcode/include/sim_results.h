@@ -0,0 +1,53 @@
+//-----------------------------------------------------------------------------
+// Title         : Simulation Result Table
+//-----------------------------------------------------------------------------
+// File          : sim_results.h
+// Author        : Custom IP Integration Example
+// Created       : 2025-11-04
+//-----------------------------------------------------------------------------
+// Description :
+// Benchmark results read back by the Verilator harness when the run ends
+// (target/sim/verilator/result_table.h). The harness finds them by symbol
+// name and reads them through the L2 backdoor, so reporting a result costs a
+// plain store and no harness changes. Results must live in L2.
+//
+//   SIM_RESULT(phase1_cycles);          // one named 32-bit result
+//   SIM_RESULT64(total_cycles);         // one named 64-bit result
+//   SIM_RESULT_TABLE(8);                // up to 8 records named at run time
+//
+//   sim_result_phase1_cycles = t1 - t0;
+//   sim_result_set(0, "iterations", n);
+//
+// They are printed at the end of the run and written to the +report JSON
+// under "results".
+//-----------------------------------------------------------------------------
+// Copyright (C) 2025 Custom IP Example
+// SPDX-License-Identifier: SHL-0.51
+//-----------------------------------------------------------------------------
+
+#ifndef __SIM_RESULTS_H__
+#define __SIM_RESULTS_H__
+
+#include <stdint.h>
+
+// Named results: the symbol sim_result_<name>
+#define SIM_RESULT(name)   volatile uint32_t sim_result_##name __attribute__((used))
+#define SIM_RESULT64(name) volatile uint64_t sim_result_##name __attribute__((used))
+
+// Records of the table; a null name ends it
+struct sim_result {
+    const char *name;
+    uint32_t    value;
+};
+
+#define SIM_RESULT_TABLE(n) volatile struct sim_result sim_results[n] __attribute__((used))
+
+extern volatile struct sim_result sim_results[];
+
+static inline void sim_result_set(int index, const char *name, uint32_t value)
+{
+    sim_results[index].value = value;
+    sim_results[index].name  = name;
+}
+
+#endif // __SIM_RESULTS_H__
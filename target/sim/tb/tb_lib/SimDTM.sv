@@ -1,7 +1,12 @@
 // See LICENSE.SiFive for license details.
 //VCS coverage exclude_file
 
-import "DPI-C" function int debug_tick
+// debug_tick is implemented in tb_lib/sim_dtm/sim_dtm.cpp on top of the
+// harness DMI server; load the library that directory builds with
+// vsim -sv_lib (questasim USE_SIM_DTM=1). It is a context function so each
+// SimDTM instance gets its own server.
+
+import "DPI-C" context function int debug_tick
 (
   output bit     debug_req_valid,
   input  bit     debug_req_ready,
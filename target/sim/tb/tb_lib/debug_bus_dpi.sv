@@ -1,19 +1,45 @@
 // Copyright 2024 Custom IP Integration
 // DPI-C interface for debug bus access without force statements
 // This allows Verilator-compatible memory loading
+//
+// The C++ side (tb_lib/debug_bus_dpi/debug_bus_dpi.cpp) keeps a queue of
+// requests. debug_bus_driver drains it back to back, one transfer per clock
+// once granted, so bursts load at one word per cycle in any simulator.
 
 package debug_bus_dpi_pkg;
 
-  // DPI-C import for C++ side (Verilator)
+  // Queue a posted write. Writes queued in one time step form a burst.
   import "DPI-C" context function void debug_bus_write_word(
     input int unsigned addr,
     input int unsigned data
   );
 
+  // Queue a read. Returns a ticket for debug_bus_read_done.
   import "DPI-C" context function int unsigned debug_bus_read_word(
     input int unsigned addr
   );
 
+  // Collect the data of a queued read once the bus has returned it
+  import "DPI-C" context function bit debug_bus_read_done(
+    input  int unsigned ticket,
+    output int unsigned data
+  );
+
+  // All queued requests issued and answered
+  import "DPI-C" context function bit debug_bus_idle();
+
+  // One bus cycle: handshake of the ending cycle in, next request out
+  import "DPI-C" context function void debug_bus_drive(
+    input  bit          gnt,
+    input  bit          r_valid,
+    input  int unsigned r_rdata,
+    output bit          req,
+    output int unsigned add,
+    output bit          wen,
+    output int unsigned wdata,
+    output bit [3:0]    be
+  );
+
   import "DPI-C" context function void debug_bus_init();
 
   import "DPI-C" context function void debug_bus_finish();
@@ -28,13 +54,26 @@ package debug_bus_dpi_pkg;
     @(posedge clk);
   endtask
 
+  // Queue `data.size()` words from `addr` and wait until all are written
+  task automatic debug_bus_write_burst(
+    input logic [31:0] addr,
+    input logic [31:0] data[],
+    ref logic clk
+  );
+    foreach (data[i]) debug_bus_write_word(addr + 4 * i, data[i]);
+    do @(posedge clk); while (!debug_bus_idle());
+  endtask
+
   task automatic debug_bus_read(
     input logic [31:0] addr,
     output logic [31:0] data,
     ref logic clk
   );
-    data = debug_bus_read_word(addr);
-    @(posedge clk);
+    int unsigned ticket;
+    int unsigned value;
+    ticket = debug_bus_read_word(addr);
+    do @(posedge clk); while (!debug_bus_read_done(ticket, value));
+    data = value;
   endtask
 
 endpackage
@@ -44,7 +83,7 @@ endpackage
 module debug_bus_driver (
   input  logic        clk_i,
   input  logic        rst_ni,
-  
+
   // Debug bus master interface (drives the bus)
   output logic        debug_req_o,
   output logic [31:0] debug_add_o,
@@ -58,18 +97,6 @@ module debug_bus_driver (
 
   import debug_bus_dpi_pkg::*;
 
-  typedef enum logic [1:0] {
-    IDLE,
-    WAIT_GRANT,
-    WAIT_VALID
-  } state_e;
-
-  state_e state;
-  logic [31:0] pending_addr;
-  logic [31:0] pending_data;
-  logic pending_write;
-  logic [31:0] read_data;
-
   initial begin
     debug_bus_init();
   end
@@ -80,74 +107,37 @@ module debug_bus_driver (
 
   always_ff @(posedge clk_i or negedge rst_ni) begin
     if (!rst_ni) begin
-      state <= IDLE;
       debug_req_o <= 1'b0;
       debug_add_o <= 32'h0;
       debug_wen_o <= 1'b1; // Default to read
       debug_wdata_o <= 32'h0;
       debug_be_o <= 4'hF;
-      pending_addr <= 32'h0;
-      pending_data <= 32'h0;
-      pending_write <= 1'b0;
-      read_data <= 32'h0;
     end else begin
-      case (state)
-        IDLE: begin
-          // Check if DPI function wants to write
-          // This is a placeholder - actual implementation would use a queue
-          // or shared memory between DPI and SystemVerilog
-          debug_req_o <= 1'b0;
-        end
-        
-        WAIT_GRANT: begin
-          if (debug_gnt_i) begin
-            state <= WAIT_VALID;
-          end
-        end
-        
-        WAIT_VALID: begin
-          if (debug_r_valid_i) begin
-            if (!pending_write) begin
-              read_data <= debug_rdata_i;
-            end
-            state <= IDLE;
-            debug_req_o <= 1'b0;
-          end
-        end
-        
-        default: state <= IDLE;
-      endcase
+      bit          req, wen;
+      int unsigned add, wdata;
+      bit [3:0]    be;
+      debug_bus_drive(debug_gnt_i, debug_r_valid_i, debug_rdata_i, req, add, wen, wdata, be);
+      debug_req_o <= req;
+      debug_add_o <= add;
+      debug_wen_o <= wen;
+      debug_wdata_o <= wdata;
+      debug_be_o <= be;
     end
   end
 
   // Task to write a word
   task write_word(input logic [31:0] addr, input logic [31:0] data);
-    pending_addr <= addr;
-    pending_data <= data;
-    pending_write <= 1'b1;
-    debug_req_o <= 1'b1;
-    debug_add_o <= addr;
-    debug_wdata_o <= data;
-    debug_wen_o <= 1'b0; // Write
-    debug_be_o <= 4'hF;
-    state <= WAIT_GRANT;
-    @(posedge clk_i);
-    while (state != IDLE) @(posedge clk_i);
+    debug_bus_write_word(addr, data);
+    do @(posedge clk_i); while (!debug_bus_idle());
   endtask
 
   // Task to read a word
   task read_word(input logic [31:0] addr, output logic [31:0] data);
-    pending_addr <= addr;
-    pending_write <= 1'b0;
-    debug_req_o <= 1'b1;
-    debug_add_o <= addr;
-    debug_wen_o <= 1'b1; // Read
-    debug_be_o <= 4'hF;
-    state <= WAIT_GRANT;
-    @(posedge clk_i);
-    while (state != IDLE) @(posedge clk_i);
-    data = read_data;
+    int unsigned ticket;
+    int unsigned value;
+    ticket = debug_bus_read_word(addr);
+    do @(posedge clk_i); while (!debug_bus_read_done(ticket, value));
+    data = value;
   endtask
 
 endmodule
-
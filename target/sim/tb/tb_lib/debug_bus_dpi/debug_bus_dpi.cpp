@@ -0,0 +1,62 @@
+// Copyright 2025 Custom IP Integration
+// C side of debug_bus_dpi_pkg (target/sim/tb/tb_lib/debug_bus_dpi.sv).
+//
+// The package functions queue requests on one DebugBusTransactor; the
+// debug_bus_driver module calls debug_bus_drive() on every rising clock edge
+// to move them over the bus. The Makefile next to this file builds it into
+// libdebugbus.so for vsim -sv_lib (questasim USE_DEBUG_BUS_DRIVER=1).
+
+#include "debug_bus_transactor.h"
+#include "svdpi.h"
+#include <iostream>
+
+static DebugBusTransactor transactor;
+
+extern "C" {
+
+void debug_bus_init() {
+    transactor.reset();
+}
+
+void debug_bus_finish() {
+    if (transactor.granted() == 0) return;
+    std::cout << "Debug bus: " << transactor.granted() << " transfers in "
+              << transactor.busy_cycles() << " busy cycles";
+    if (!transactor.idle()) std::cout << ", " << transactor.queued() << " never issued";
+    std::cout << std::endl;
+}
+
+// Posted write; consecutive calls in one time step form a burst
+void debug_bus_write_word(unsigned int addr, unsigned int data) {
+    transactor.write(addr, data);
+}
+
+// Queue a read and return its ticket for debug_bus_read_done()
+unsigned int debug_bus_read_word(unsigned int addr) {
+    return transactor.read(addr);
+}
+
+svBit debug_bus_read_done(unsigned int ticket, unsigned int* data) {
+    uint32_t value = 0;
+    if (!transactor.read_result(ticket, value)) return 0;
+    *data = value;
+    return 1;
+}
+
+svBit debug_bus_idle() {
+    return transactor.idle();
+}
+
+// Called at each rising edge with the handshake of the cycle that ends
+void debug_bus_drive(svBit gnt, svBit r_valid, unsigned int r_rdata,
+                     svBit* req, unsigned int* add, svBit* wen, unsigned int* wdata,
+                     svBitVecVal* be) {
+    DebugBusTransactor::Pins p = transactor.cycle(gnt, r_valid, r_rdata);
+    *req = p.req;
+    *add = p.add;
+    *wen = p.wen;
+    *wdata = p.wdata;
+    *be = p.be;
+}
+
+} // extern "C"
@@ -0,0 +1,89 @@
+// Copyright 2025 Custom IP Integration
+// C side of SimDTM (target/sim/tb/tb_lib/SimDTM.sv).
+//
+// SimDTM replaces the JTAG DTM with a direct DMI master. debug_tick() is
+// called on every rising clock edge; it moves the requests of a DmiServer
+// client onto the DMI request channel one at a time and sends each response
+// back. Every SimDTM instance has its own server, found through its DPI
+// scope. The first one listens on $DMI_SERVER_PORT (default: any free port),
+// the others on any free port; each port is printed. The return value is
+// SimDTM's `exit` output: 0 while running, exit code << 1 | 1 once the client
+// sent OP_QUIT, as for jtag_tick().
+//
+// Built into libsimdtm.so by the Makefile next to this file, for vsim -sv_lib.
+
+#include "dmi_server.h"
+#include "svdpi.h"
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+struct SimDtm {
+    DmiServer server;
+    DmiHost::Request current;
+    bool presenting;  // Request on the bus, not accepted yet
+    bool in_flight;   // Accepted, waiting for the response
+
+    SimDtm() : current(), presenting(false), in_flight(false) {}
+};
+
+// Key for svPutUserData; only its address matters
+char user_data_key;
+bool env_port_taken = false;
+
+SimDtm* instance() {
+    svScope scope = svGetScope();
+    SimDtm* dtm = static_cast<SimDtm*>(svGetUserData(scope, &user_data_key));
+    if (dtm) return dtm;
+
+    dtm = new SimDtm;
+    svPutUserData(scope, &user_data_key, dtm);
+    const char* port = env_port_taken ? nullptr : getenv("DMI_SERVER_PORT");
+    env_port_taken = true;
+    if (dtm->server.listen(port ? atoi(port) : 0)) {
+        std::cout << "SimDTM " << svGetNameFromScope(scope) << ": DMI server listening on port "
+                  << dtm->server.port() << std::endl;
+    }
+    return dtm;
+}
+
+} // namespace
+
+extern "C" int debug_tick(svBit* debug_req_valid, svBit debug_req_ready,
+                          int* debug_req_bits_addr, int* debug_req_bits_op,
+                          int* debug_req_bits_data, svBit debug_resp_valid,
+                          svBit* debug_resp_ready, int debug_resp_bits_resp,
+                          int debug_resp_bits_data) {
+    SimDtm* dtm = instance();
+    DmiServer& server = dtm->server;
+
+    // Handshakes of the cycle that ends
+    if (dtm->presenting && debug_req_ready) {
+        dtm->presenting = false;
+        dtm->in_flight = true;
+    }
+    if (dtm->in_flight && debug_resp_valid) {
+        server.respond(debug_resp_bits_resp == 0 ? DmiHost::RESP_OK : DmiHost::RESP_FAILED,
+                       dtm->current.addr, (uint32_t)debug_resp_bits_data);
+        dtm->in_flight = false;
+    }
+
+    server.tick();
+    while (!dtm->presenting && !dtm->in_flight && server.pending()) {
+        dtm->current = server.front();
+        server.pop();
+        if (dtm->current.op == DmiHost::OP_NOP) {
+            server.respond(DmiHost::RESP_OK, dtm->current.addr, 0);
+        } else {
+            dtm->presenting = true;
+        }
+    }
+
+    *debug_req_valid = dtm->presenting;
+    *debug_req_bits_addr = dtm->current.addr;
+    *debug_req_bits_op = dtm->current.op;
+    *debug_req_bits_data = (int)dtm->current.data;
+    *debug_resp_ready = 1;
+    return server.quit() ? (server.exit_code() << 1 | 1) : 0;
+}
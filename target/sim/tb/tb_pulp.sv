@@ -852,6 +852,21 @@ module tb_pulp;
   // Connect debug bus driver to actual debug bus (when not using force)
   // This allows Verilator-compatible access
   `ifdef USE_DEBUG_BUS_DRIVER
+    // Requests come from the DPI transactor (tb_lib/debug_bus_dpi), one
+    // word per cycle once granted
+    debug_bus_driver i_debug_bus_driver (
+      .clk_i           ( i_dut.i_soc_domain.i_pulp_soc.i_soc_interconnect_wrap.clk_i ),
+      .rst_ni          ( w_rst_n           ),
+      .debug_req_o     ( debug_bus_req     ),
+      .debug_add_o     ( debug_bus_add     ),
+      .debug_wen_o     ( debug_bus_wen     ),
+      .debug_wdata_o   ( debug_bus_wdata   ),
+      .debug_be_o      ( debug_bus_be      ),
+      .debug_gnt_i     ( debug_bus_gnt     ),
+      .debug_rdata_i   ( debug_bus_rdata   ),
+      .debug_r_valid_i ( debug_bus_r_valid )
+    );
+
     // Use direct assignment instead of force
     assign i_dut.i_soc_domain.i_pulp_soc.i_soc_interconnect_wrap.tcdm_debug.req = debug_bus_req;
     assign i_dut.i_soc_domain.i_pulp_soc.i_soc_interconnect_wrap.tcdm_debug.add = debug_bus_add;
@@ -870,36 +885,22 @@ module tb_pulp;
     $display("[TB] %t: Preloading L2 with stimuli through direct access.", $realtime);
     
     `ifdef USE_DEBUG_BUS_DRIVER
-      // Use direct assignment (Verilator-compatible)
+      // Queue the whole image as one burst, then wait until the driver has
+      // written every word
       while (more_stim == 1'b1) begin
-        @(posedge i_dut.i_soc_domain.i_pulp_soc.i_soc_interconnect_wrap.clk_i);
         stim_entry = stimuli[num_stim];
-        
-        // Write first word
-        debug_bus_req = 1'b1;
-        debug_bus_add = stim_entry[95:64];
-        debug_bus_wdata = stim_entry[31:0];
-        debug_bus_wen = 1'b0;
-        debug_bus_be = '1;
-        do begin
-          @(posedge i_dut.i_soc_domain.i_pulp_soc.i_soc_interconnect_wrap.clk_i);
-        end while (~debug_bus_gnt);
-        
-        // Write second word
-        debug_bus_add = stim_entry[95:64] + 32'h4;
-        debug_bus_wdata = stim_entry[63:32];
-        do begin
-          @(posedge i_dut.i_soc_domain.i_pulp_soc.i_soc_interconnect_wrap.clk_i);
-        end while (~debug_bus_gnt);
-        
+        debug_bus_dpi_pkg::debug_bus_write_word(stim_entry[95:64], stim_entry[31:0]);
+        debug_bus_dpi_pkg::debug_bus_write_word(stim_entry[95:64] + 32'h4, stim_entry[63:32]);
+
         num_stim = num_stim + 1;
         if (num_stim > $size(stimuli) || stimuli[num_stim] === 96'bx) begin
           more_stim = 0;
           break;
         end
       end
-      debug_bus_req = 1'b0;
-      @(posedge i_dut.i_soc_domain.i_pulp_soc.i_soc_interconnect_wrap.clk_i);
+      do begin
+        @(posedge i_dut.i_soc_domain.i_pulp_soc.i_soc_interconnect_wrap.clk_i);
+      end while (!debug_bus_dpi_pkg::debug_bus_idle());
     `else
       // Original implementation using force (Questasim-only)
       while (more_stim == 1'b1) begin
@@ -0,0 +1,119 @@
+// Copyright 2025 Custom IP Integration
+// Passive write snooper on the SoC interconnect master ports.
+//
+// The snooper watches the request phase (req && gnt && !wen) of the TCDM bus
+// masters and records writes to a small set of configured word addresses. It
+// never drives the bus, so it costs no simulated cycles and does not perturb
+// interconnect arbitration.
+
+#ifndef BUS_SNOOPER_H
+#define BUS_SNOOPER_H
+
+#include "Vpulpissimo.h"
+#include "Vpulpissimo_XBAR_TCDM_BUS.h"
+#include "sim_monitor.h"
+#include "tb_hier.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class BusSnooper : public SimMonitor {
+public:
+    struct Watch {
+        uint32_t addr;       // Word-aligned address
+        bool stop;           // Stop the simulation on a matching write
+        uint32_t stop_mask;  // Only stop if (word & stop_mask) == stop_value
+        uint32_t stop_value;
+        bool written;        // Set once the address has been written
+        uint32_t value;      // Last value written (merged under byte enables)
+        uint64_t cycle;      // Cycle of the last write
+    };
+
+    explicit BusSnooper(Vpulpissimo* top) : stop_(false), stop_watch_(-1) {
+        add_port("fc_data", TB_FC_DATA_BUS(top));
+        add_port("debug", TB_DEBUG_BUS(top));
+        add_port("udma_rx", TB_UDMA_RX_BUS(top));
+    }
+
+    // Record writes to `addr`. Returns the watch index.
+    int watch(uint32_t addr) {
+        Watch w = {addr & ~0x3u, false, 0, 0, false, 0, 0};
+        watches_.push_back(w);
+        return (int)watches_.size() - 1;
+    }
+
+    // Stop the simulation on the first write to `addr`
+    int stop_on_write(uint32_t addr) {
+        int idx = watch(addr);
+        watches_[idx].stop = true;
+        return idx;
+    }
+
+    // Stop the simulation on the first write of `value` to `addr`
+    int stop_on_value(uint32_t addr, uint32_t value) {
+        return stop_on_bits(addr, 0xFFFFFFFFu, value);
+    }
+
+    // Stop the simulation on the first write to `addr` whose `mask` bits equal `value`
+    int stop_on_bits(uint32_t addr, uint32_t mask, uint32_t value) {
+        int idx = stop_on_write(addr);
+        watches_[idx].stop_mask = mask;
+        watches_[idx].stop_value = value & mask;
+        return idx;
+    }
+
+    const Watch& get_watch(int idx) const { return watches_[idx]; }
+
+    // Index of the watch that ended the simulation, or -1
+    int stop_watch() const { return stop_watch_; }
+
+    void sample(uint64_t cycle) override {
+        for (const Port& p : ports_) {
+            const Vpulpissimo_XBAR_TCDM_BUS* bus = p.bus;
+            if (!bus->req || !bus->gnt || bus->wen) continue;
+            uint32_t addr = bus->add & ~0x3u;
+            for (size_t i = 0; i < watches_.size(); i++) {
+                Watch& w = watches_[i];
+                if (w.addr != addr) continue;
+                uint32_t mask = be_mask(bus->be);
+                w.value = (w.value & ~mask) | (bus->wdata & mask);
+                w.written = true;
+                w.cycle = cycle;
+                if (w.stop && !stop_ && (w.value & w.stop_mask) == w.stop_value) {
+                    stop_ = true;
+                    stop_watch_ = (int)i;
+                }
+            }
+        }
+    }
+
+    bool stop_requested() const override { return stop_; }
+
+private:
+    struct Port {
+        std::string name;
+        const Vpulpissimo_XBAR_TCDM_BUS* bus;
+    };
+
+    void add_port(const char* name, const Vpulpissimo_XBAR_TCDM_BUS* bus) {
+        if (bus) {
+            Port p = {name, bus};
+            ports_.push_back(p);
+        }
+    }
+
+    static uint32_t be_mask(uint32_t be) {
+        uint32_t mask = 0;
+        for (int i = 0; i < 4; i++) {
+            if (be & (1 << i)) mask |= 0xFFu << (i * 8);
+        }
+        return mask;
+    }
+
+    std::vector<Port> ports_;
+    std::vector<Watch> watches_;
+    bool stop_;
+    int stop_watch_;
+};
+
+#endif // BUS_SNOOPER_H
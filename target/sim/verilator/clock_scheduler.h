@@ -0,0 +1,198 @@
+// Copyright 2025 Custom IP Integration
+// Multi-clock edge scheduler for the Verilator harness.
+//
+// Each clock is a free-running square wave driving one model input. Pending
+// edges live in a small hashed timing wheel: slot width is the shortest half
+// period, so the fast clocks land in nearby slots while slow clocks (the
+// 32 kHz reference) simply wait for their round. advance() jumps straight to
+// the next edge time and toggles every clock with an edge at that time, so
+// the caller evaluates the model only on real edges.
+
+#ifndef CLOCK_SCHEDULER_H
+#define CLOCK_SCHEDULER_H
+
+#include "verilated.h"
+#ifdef TB_SAVABLE
+#include "verilated_save.h"
+#endif
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ClockScheduler {
+public:
+    static const int MAX_CLOCKS = 8;
+    static const int WHEEL_SLOTS = 64;
+
+    ClockScheduler() : time_ps_(0), slot_ps_(0), cursor_(0), main_(-1) {}
+
+    // Register a clock toggling *signal with the given period. The first
+    // rising edge happens at phase_ps + period_ps / 2. Returns the clock id.
+    int add_clock(const char* name, uint64_t period_ps, CData* signal, uint64_t phase_ps = 0) {
+        Clock c;
+        c.name = name;
+        c.half_period_ps = period_ps / 2;
+        c.signal = signal;
+        c.level = false;
+        c.next_edge_ps = time_ps_ + phase_ps + c.half_period_ps;
+        c.rising_edges = 0;
+        *signal = 0;
+        clocks_.push_back(c);
+        if (main_ < 0) main_ = 0;
+        rebuild_wheel();
+        return (int)clocks_.size() - 1;
+    }
+
+    // The main clock defines "cycles" for max_cycles, monitors and reports
+    void set_main(int id) { main_ = id; }
+    int main_clock() const { return main_; }
+    uint32_t main_mask() const { return 1u << main_; }
+
+    // Advance to the next edge time and toggle all clocks with an edge there.
+    // Returns the mask of clocks that rose. The model is not evaluated.
+    uint32_t advance() {
+        uint64_t t = next_edge_time();
+        time_ps_ = t;
+        uint32_t rising = 0;
+        std::vector<int>& slot = wheel_[slot_of(t)];
+        for (size_t i = 0; i < slot.size();) {
+            Clock& c = clocks_[slot[i]];
+            if (c.next_edge_ps != t) {
+                i++;
+                continue;
+            }
+            int id = slot[i];
+            slot[i] = slot.back();
+            slot.pop_back();
+            c.level = !c.level;
+            *c.signal = c.level;
+            if (c.level) {
+                c.rising_edges++;
+                rising |= 1u << id;
+            }
+            c.next_edge_ps = t + c.half_period_ps;
+            wheel_[slot_of(c.next_edge_ps)].push_back(id);
+        }
+        return rising;
+    }
+
+    // Jump `delta_ps` ahead without producing the edges in between. Edge
+    // counts are updated as if the clocks had run. A clock that would end up
+    // at the opposite level keeps its current one and takes that last edge
+    // on the next advance(), so the model never sees a level change it did not
+    // evaluate. Skipping whole main-clock periods keeps the main clock exact.
+    void skip(uint64_t delta_ps) {
+        uint64_t target = time_ps_ + delta_ps;
+        for (Clock& c : clocks_) {
+            if (c.next_edge_ps > target) continue;
+            uint64_t edges = (target - c.next_edge_ps) / c.half_period_ps + 1;
+            bool deferred = edges & 1;
+            if (deferred) edges--;
+            c.rising_edges += edges / 2;
+            c.next_edge_ps = deferred ? target : c.next_edge_ps + edges * c.half_period_ps;
+        }
+        time_ps_ = target;
+        rebuild_wheel();
+    }
+
+    uint64_t time_ps() const { return time_ps_; }
+    uint64_t cycles(int id) const { return clocks_[id].rising_edges; }
+    uint64_t get_cycle() const { return clocks_[main_].rising_edges; }
+    uint64_t period_ps(int id) const { return 2 * clocks_[id].half_period_ps; }
+    const std::string& name(int id) const { return clocks_[id].name; }
+    size_t num_clocks() const { return clocks_.size(); }
+
+    // Time of the next rising edge of clock `id`
+    uint64_t next_rise_ps(int id) const {
+        const Clock& c = clocks_[id];
+        return c.level ? c.next_edge_ps + c.half_period_ps : c.next_edge_ps;
+    }
+
+#ifdef TB_SAVABLE
+    void save(VerilatedSerialize& os) {
+        uint32_t n = clocks_.size();
+        os.write(&n, sizeof(n));
+        os.write(&time_ps_, sizeof(time_ps_));
+        for (Clock& c : clocks_) {
+            os.write(&c.half_period_ps, sizeof(c.half_period_ps));
+            os.write(&c.level, sizeof(c.level));
+            os.write(&c.next_edge_ps, sizeof(c.next_edge_ps));
+            os.write(&c.rising_edges, sizeof(c.rising_edges));
+        }
+    }
+
+    // Clocks must be registered with the same periods as when saving
+    bool restore(VerilatedDeserialize& is) {
+        uint32_t n = 0;
+        is.read(&n, sizeof(n));
+        if (n != clocks_.size()) return false;
+        is.read(&time_ps_, sizeof(time_ps_));
+        for (Clock& c : clocks_) {
+            uint64_t half_period = 0;
+            is.read(&half_period, sizeof(half_period));
+            is.read(&c.level, sizeof(c.level));
+            is.read(&c.next_edge_ps, sizeof(c.next_edge_ps));
+            is.read(&c.rising_edges, sizeof(c.rising_edges));
+            if (half_period != c.half_period_ps) return false;
+            *c.signal = c.level;
+        }
+        rebuild_wheel();
+        return true;
+    }
+#endif
+
+private:
+    struct Clock {
+        std::string name;
+        uint64_t half_period_ps;
+        CData* signal;
+        bool level;
+        uint64_t next_edge_ps;
+        uint64_t rising_edges;
+    };
+
+    size_t slot_of(uint64_t t) const { return (t / slot_ps_) % WHEEL_SLOTS; }
+
+    void rebuild_wheel() {
+        slot_ps_ = UINT64_MAX;
+        for (const Clock& c : clocks_) {
+            if (c.half_period_ps < slot_ps_) slot_ps_ = c.half_period_ps;
+        }
+        if (slot_ps_ == 0) slot_ps_ = 1;
+        for (int i = 0; i < WHEEL_SLOTS; i++) wheel_[i].clear();
+        for (size_t i = 0; i < clocks_.size(); i++) {
+            wheel_[slot_of(clocks_[i].next_edge_ps)].push_back(i);
+        }
+        cursor_ = time_ps_ / slot_ps_;
+    }
+
+    // Scan the wheel from the current slot for the earliest edge in this
+    // round. If the whole round is empty, only slow clocks are pending and we
+    // jump straight to the earliest of them.
+    uint64_t next_edge_time() {
+        for (int n = 0; n < WHEEL_SLOTS; n++, cursor_++) {
+            uint64_t slot_end = (cursor_ + 1) * slot_ps_;
+            uint64_t best = UINT64_MAX;
+            for (int id : wheel_[cursor_ % WHEEL_SLOTS]) {
+                uint64_t t = clocks_[id].next_edge_ps;
+                if (t < slot_end && t < best) best = t;
+            }
+            if (best != UINT64_MAX) return best;
+        }
+        uint64_t best = UINT64_MAX;
+        for (const Clock& c : clocks_) {
+            if (c.next_edge_ps < best) best = c.next_edge_ps;
+        }
+        cursor_ = best / slot_ps_;
+        return best;
+    }
+
+    std::vector<Clock> clocks_;
+    std::vector<int> wheel_[WHEEL_SLOTS];
+    uint64_t time_ps_;
+    uint64_t slot_ps_;
+    uint64_t cursor_;
+    int main_;
+};
+
+#endif // CLOCK_SCHEDULER_H
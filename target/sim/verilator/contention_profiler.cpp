@@ -0,0 +1,261 @@
+// Copyright 2025 Custom IP Integration
+// Interconnect contention and L2 bank-conflict profiler.
+
+#include "contention_profiler.h"
+#include "l2_backdoor.h"
+#include "tb_console.h"
+#include "tb_format.h"
+#include "tb_hier.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+static const char* BANK_NAMES[ContentionProfiler::NUM_BANKS] = {
+    "pri0", "pri1", "intl0", "intl1", "intl2", "intl3", "other"
+};
+
+// Heat map shades, coldest first
+static const char HEAT[] = " .:-=+*#%@";
+
+ContentionProfiler::ContentionProfiler(Vpulpissimo* top, const ElfImage* elf, uint32_t range_bytes)
+    : elf_(elf), range_bytes_(std::max(4u, range_bytes)), snooper_(nullptr), freeze_watch_(-1),
+      frozen_(false), frozen_cycle_(0), cycles_(0) {
+    add_port("fc_data", TB_FC_DATA_BUS(top));
+    add_port("fc_instr", TB_FC_INSTR_BUS(top));
+    add_port("udma_rx", TB_UDMA_RX_BUS(top));
+    add_port("udma_tx", TB_UDMA_TX_BUS(top));
+    add_port("debug", TB_DEBUG_BUS(top));
+    memset(cells_, 0, sizeof(cells_));
+    memset(bank_conflicts_, 0, sizeof(bank_conflicts_));
+}
+
+void ContentionProfiler::add_port(const char* name, const Vpulpissimo_XBAR_TCDM_BUS* bus) {
+    if (!bus) return;
+    Master m;
+    m.name = name;
+    m.bus = bus;
+    m.requests = m.granted = m.stalls = m.conflicts = m.longest = m.run = 0;
+    memset(m.blame, 0, sizeof(m.blame));
+    masters_.push_back(m);
+}
+
+void ContentionProfiler::freeze_on_write(const BusSnooper* snooper, int watch) {
+    snooper_ = snooper;
+    freeze_watch_ = watch;
+}
+
+ContentionProfiler::Bank ContentionProfiler::bank_of(uint32_t addr) {
+    if (!L2Backdoor::contains(addr)) return OTHER;
+    if (addr < L2_PRI1_START_ADDR) return PRI0;
+    if (addr < L2_INTL_START_ADDR) return PRI1;
+    return (Bank)(INTL0 + ((addr - L2_INTL_START_ADDR) >> 2) % L2_INTL_NB_BANKS);
+}
+
+void ContentionProfiler::sample(uint64_t cycle) {
+    if (frozen_) return;
+    if (freeze_watch_ >= 0 && snooper_->get_watch(freeze_watch_).written) {
+        frozen_ = true;
+        frozen_cycle_ = cycle;
+        return;
+    }
+    cycles_++;
+
+    // Which masters want which bank this cycle
+    int bank[MAX_MASTERS];
+    unsigned users[NUM_BANKS] = {0};
+    bool any = false;
+    for (size_t i = 0; i < masters_.size(); i++) {
+        const Vpulpissimo_XBAR_TCDM_BUS* bus = masters_[i].bus;
+        bank[i] = bus->req ? bank_of(bus->add) : -1;
+        if (bank[i] >= 0) {
+            users[bank[i]] |= 1u << i;
+            any = true;
+        } else {
+            masters_[i].run = 0;
+        }
+    }
+    if (!any) return;
+    for (int b = 0; b < NUM_BANKS; b++) {
+        if (users[b] & (users[b] - 1)) bank_conflicts_[b]++;
+    }
+
+    for (size_t i = 0; i < masters_.size(); i++) {
+        if (bank[i] < 0) continue;
+        Master& m = masters_[i];
+        uint32_t addr = m.bus->add;
+        Cell& cell = cells_[bank[i]][i];
+        Range& r = ranges_[addr / range_bytes_];
+        m.requests++;
+        if (m.bus->gnt) {
+            m.granted++;
+            cell.granted++;
+            r.granted++;
+            m.run = 0;
+            continue;
+        }
+        m.stalls++;
+        cell.stalls++;
+        if (!r.stalls) r.hot_addr = addr;
+        r.stalls++;
+        r.master_stalls[i]++;
+        if (++m.run > m.longest) m.longest = m.run;
+        unsigned others = users[bank[i]] & ~(1u << i);
+        if (!others) {
+            m.blame[masters_.size()]++;
+            continue;
+        }
+        m.conflicts++;
+        r.conflicts++;
+        for (size_t j = 0; j < masters_.size(); j++) {
+            if (others & (1u << j)) m.blame[j]++;
+        }
+    }
+}
+
+std::vector<std::pair<std::string, uint64_t>> ContentionProfiler::master_stalls() const {
+    std::vector<std::pair<std::string, uint64_t>> stalls;
+    for (const Master& m : masters_) stalls.emplace_back(m.name, m.stalls);
+    return stalls;
+}
+
+// Ranges that stalled anyone, worst first
+std::vector<std::pair<uint32_t, const ContentionProfiler::Range*>> ContentionProfiler::by_stalls() const {
+    std::vector<std::pair<uint32_t, const Range*>> order;
+    for (const auto& r : ranges_) {
+        if (r.second.stalls) order.emplace_back(r.first * range_bytes_, &r.second);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<uint32_t, const Range*>& a,
+                                             const std::pair<uint32_t, const Range*>& b) {
+        return a.second->stalls != b.second->stalls ? a.second->stalls > b.second->stalls : a.first < b.first;
+    });
+    return order;
+}
+
+// Interleaved ranges wider than a word spread over all cuts
+const char* ContentionProfiler::range_bank(const Range& r) const {
+    Bank b = bank_of(r.hot_addr);
+    return b >= INTL0 && b <= INTL3 && range_bytes_ > 4 ? "intl" : BANK_NAMES[b];
+}
+
+std::string ContentionProfiler::range_symbol(const Range& r) const {
+    const ElfImage::Symbol* s = elf_ ? elf_->symbol_at(r.hot_addr) : nullptr;
+    if (!s) return "";
+    if (r.hot_addr == s->addr) return s->name;
+    std::ostringstream os;
+    os << s->name << "+0x" << std::hex << r.hot_addr - s->addr;
+    return os.str();
+}
+
+void ContentionProfiler::write_masters(std::ostream& os) const {
+    os << "Interconnect contention (" << cycles_ << " cycles";
+    if (frozen_) os << ", until cycle " << frozen_cycle_;
+    os << "):\n";
+    os << "  " << std::left << std::setw(10) << "master" << std::right << std::setw(12) << "requests"
+       << std::setw(12) << "granted" << std::setw(12) << "stalls" << std::setw(12) << "conflicts"
+       << std::setw(10) << "longest" << std::setw(9) << "stall%" << "\n";
+    for (const Master& m : masters_) {
+        os << "  " << std::left << std::setw(10) << m.name << std::right << std::setw(12) << m.requests
+           << std::setw(12) << m.granted << std::setw(12) << m.stalls << std::setw(12) << m.conflicts
+           << std::setw(10) << m.longest << std::setw(9)
+           << tb_fixed(m.requests ? 100.0 * m.stalls / m.requests : 0.0, 2) << "\n";
+    }
+}
+
+// Stall cycles per bank and master, shaded relative to the hottest cell
+void ContentionProfiler::write_heat_map(std::ostream& os) const {
+    uint64_t hottest = 0;
+    for (int b = 0; b < NUM_BANKS; b++) {
+        for (size_t i = 0; i < masters_.size(); i++) hottest = std::max(hottest, cells_[b][i].stalls);
+    }
+    os << "Stall cycles per L2 bank (heat '" << HEAT << "'):\n";
+    os << "  " << std::left << std::setw(8) << "bank" << std::right;
+    for (const Master& m : masters_) os << std::setw(14) << m.name;
+    os << std::setw(12) << "granted" << std::setw(12) << "conflicts" << "\n";
+    for (int b = 0; b < NUM_BANKS; b++) {
+        uint64_t granted = 0;
+        os << "  " << std::left << std::setw(8) << BANK_NAMES[b] << std::right;
+        for (size_t i = 0; i < masters_.size(); i++) {
+            uint64_t s = cells_[b][i].stalls;
+            size_t shade = hottest ? (size_t)((s * (sizeof(HEAT) - 2) + hottest - 1) / hottest) : 0;
+            os << std::setw(12) << s << " " << HEAT[shade];
+            granted += cells_[b][i].granted;
+        }
+        os << std::setw(12) << granted << std::setw(12) << bank_conflicts_[b] << "\n";
+    }
+}
+
+void ContentionProfiler::write_blame(std::ostream& os) const {
+    os << "Stall cycles by master on the same bank (rows stalled, columns blocking):\n";
+    os << "  " << std::left << std::setw(10) << "" << std::right;
+    for (const Master& m : masters_) os << std::setw(10) << m.name;
+    os << std::setw(10) << "none" << "\n";
+    for (const Master& m : masters_) {
+        os << "  " << std::left << std::setw(10) << m.name << std::right;
+        for (size_t j = 0; j <= masters_.size(); j++) os << std::setw(10) << m.blame[j];
+        os << "\n";
+    }
+}
+
+void ContentionProfiler::write_ranges(std::ostream& os, size_t n) const {
+    std::vector<std::pair<uint32_t, const Range*>> order = by_stalls();
+    os << "Most stalled address ranges (" << range_bytes_ << " bytes):\n";
+    if (order.empty()) {
+        os << "  none\n";
+        return;
+    }
+    os << "  " << std::left << std::setw(23) << "range" << std::setw(7) << "bank" << std::right
+       << std::setw(12) << "granted" << std::setw(12) << "stalls" << std::setw(12) << "conflicts"
+       << "  " << std::left << std::setw(10) << "worst" << "symbol" << std::right << "\n";
+    for (size_t k = 0; k < order.size() && k < n; k++) {
+        const Range& r = *order[k].second;
+        size_t worst = 0;
+        for (size_t i = 1; i < masters_.size(); i++) {
+            if (r.master_stalls[i] > r.master_stalls[worst]) worst = i;
+        }
+        std::ostringstream range;
+        range << std::hex << std::setfill('0') << "0x" << std::setw(8) << order[k].first << "-0x"
+              << std::setw(8) << order[k].first + range_bytes_;
+        os << "  " << std::left << std::setw(23) << range.str() << std::setw(7) << range_bank(r)
+           << std::right << std::setw(12) << r.granted << std::setw(12) << r.stalls << std::setw(12) << r.conflicts
+           << "  " << std::left << std::setw(10) << masters_[worst].name << range_symbol(r) << std::right << "\n";
+    }
+}
+
+void ContentionProfiler::print_summary(size_t n) const {
+    write_masters(tb_out());
+    write_heat_map(tb_out());
+    write_blame(tb_out());
+    write_ranges(tb_out(), n);
+    tb_out().flush();
+}
+
+bool ContentionProfiler::write(const std::string& prefix) const {
+    std::ofstream txt(prefix + ".txt");
+    if (!txt) return false;
+    write_masters(txt);
+    txt << "\n";
+    write_heat_map(txt);
+    txt << "\n";
+    write_blame(txt);
+    txt << "\n";
+    write_ranges(txt, ranges_.size());
+
+    // One line per stalled range, for spreadsheets and placement scripts
+    std::ofstream csv(prefix + ".ranges.csv");
+    if (!csv) return false;
+    csv << "start,end,bank,symbol,granted,stalls,conflicts";
+    for (const Master& m : masters_) csv << "," << m.name;
+    csv << "\n";
+    for (const auto& e : by_stalls()) {
+        const Range& r = *e.second;
+        csv << "0x" << std::hex << e.first << ",0x" << e.first + range_bytes_ << std::dec << ","
+            << range_bank(r) << "," << range_symbol(r) << "," << r.granted << ","
+            << r.stalls << "," << r.conflicts;
+        for (size_t i = 0; i < masters_.size(); i++) csv << "," << r.master_stalls[i];
+        csv << "\n";
+    }
+    return txt.good() && csv.good();
+}
@@ -0,0 +1,109 @@
+// Copyright 2025 Custom IP Integration
+// Interconnect contention and L2 bank-conflict profiler.
+//
+// CSR_PCER_TCDM_CONT only says that the FC lost cycles waiting for a grant.
+// This monitor watches the request/grant handshake of every SoC interconnect
+// master port (FC data and instruction, uDMA RX and TX, debug) and charges
+// each stall cycle (req && !gnt) to the master, to the L2 bank its address
+// decodes to and to an address range. A stall is blamed on the other masters
+// that requested the same bank in that cycle; with none in sight it is
+// counted as `none` (slave wait states, peripheral accesses).
+//
+// Banks follow l2_backdoor.h: the two private banks, the four word-
+// interleaved cuts and `other` for everything outside L2. The result is a
+// bank x master heat map of stall cycles, a stalled x blocking master matrix
+// and a table of the address ranges that stalled most, named after the ELF
+// symbol they hold. Like the FC counters, counting stops at the benchmark's
+// result marker.
+
+#ifndef CONTENTION_PROFILER_H
+#define CONTENTION_PROFILER_H
+
+#include "Vpulpissimo.h"
+#include "Vpulpissimo_XBAR_TCDM_BUS.h"
+#include "bus_snooper.h"
+#include "elf_loader.h"
+#include "sim_monitor.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class ContentionProfiler : public SimMonitor {
+public:
+    enum Bank { PRI0, PRI1, INTL0, INTL1, INTL2, INTL3, OTHER, NUM_BANKS };
+    static const int MAX_MASTERS = 5;
+
+    // `elf` names the address ranges and may be nullptr. `range_bytes` is
+    // the granularity of the range table.
+    ContentionProfiler(Vpulpissimo* top, const ElfImage* elf, uint32_t range_bytes);
+
+    // Stop counting once `watch` of `snooper` has been written
+    void freeze_on_write(const BusSnooper* snooper, int watch);
+
+    void sample(uint64_t cycle) override;
+
+    static Bank bank_of(uint32_t addr);
+
+    // Stall cycles per master, for the run report
+    std::vector<std::pair<std::string, uint64_t>> master_stalls() const;
+
+    // Master table, heat map and the `n` worst address ranges
+    void print_summary(size_t n) const;
+
+    // Write <prefix>.txt (all tables, every range) and <prefix>.ranges.csv.
+    // Returns false on I/O error.
+    bool write(const std::string& prefix) const;
+
+private:
+    struct Master {
+        std::string name;
+        const Vpulpissimo_XBAR_TCDM_BUS* bus;
+        uint64_t requests;          // Cycles with req high
+        uint64_t granted;
+        uint64_t stalls;            // req && !gnt
+        uint64_t conflicts;         // ... with another master on the same bank
+        uint64_t longest;           // Longest wait for one grant
+        uint64_t run;
+        uint64_t blame[MAX_MASTERS + 1]; // Stall cycles by blocking master, last = none
+    };
+
+    struct Cell {
+        uint64_t granted;
+        uint64_t stalls;
+    };
+
+    struct Range {
+        uint64_t granted;
+        uint64_t stalls;
+        uint64_t conflicts;
+        uint64_t master_stalls[MAX_MASTERS];
+        uint32_t hot_addr;          // First stalled address, names the range
+    };
+
+    void add_port(const char* name, const Vpulpissimo_XBAR_TCDM_BUS* bus);
+    std::vector<std::pair<uint32_t, const Range*>> by_stalls() const;
+    const char* range_bank(const Range& r) const;
+    std::string range_symbol(const Range& r) const;
+    void write_masters(std::ostream& os) const;
+    void write_heat_map(std::ostream& os) const;
+    void write_blame(std::ostream& os) const;
+    void write_ranges(std::ostream& os, size_t n) const;
+
+    const ElfImage* elf_;
+    uint32_t range_bytes_;
+    std::vector<Master> masters_;
+    Cell cells_[NUM_BANKS][MAX_MASTERS];
+    uint64_t bank_conflicts_[NUM_BANKS]; // Cycles with two or more masters on the bank
+    std::unordered_map<uint32_t, Range> ranges_; // By address / range_bytes_
+
+    const BusSnooper* snooper_;
+    int freeze_watch_;
+    bool frozen_;
+    uint64_t frozen_cycle_;
+    uint64_t cycles_;
+};
+
+#endif // CONTENTION_PROFILER_H
@@ -0,0 +1,134 @@
+// Copyright 2025 Custom IP Integration
+// Pipelined master for the SoC debug bus (XBAR_TCDM_BUS protocol).
+//
+// Requests are queued and presented back to back: the cycle a request is
+// granted the next one is already on the bus, so a burst moves one word per
+// cycle. Responses (r_valid, one per granted request, in order) are matched
+// to the outstanding requests; read data is kept per ticket until collected.
+//
+// The transactor knows nothing about the simulator. Once per bus clock it is
+// given the handshake inputs sampled just before the rising edge and returns
+// the request to present for the next cycle. The Verilator harness calls it
+// on the Verilated debug bus; tb_lib/debug_bus_dpi/debug_bus_dpi.cpp calls it
+// from the debug_bus_driver module so Questa and Verilator runs behave the
+// same.
+
+#ifndef DEBUG_BUS_TRANSACTOR_H
+#define DEBUG_BUS_TRANSACTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+class DebugBusTransactor {
+public:
+    // Request pins for the next cycle
+    struct Pins {
+        bool req;
+        uint32_t add;
+        bool wen;            // 1 = read
+        uint32_t wdata;
+        uint8_t be;
+    };
+
+    DebugBusTransactor()
+        : next_ticket_(1), presented_(false), granted_(0), responses_(0), busy_cycles_(0) {}
+
+    void reset() {
+        queue_.clear();
+        outstanding_.clear();
+        results_.clear();
+        presented_ = false;
+    }
+
+    // Queue a posted write
+    void write(uint32_t addr, uint32_t data, uint8_t be = 0xF) {
+        Request r = {addr & ~0x3u, data, be, true, 0};
+        queue_.push_back(r);
+    }
+
+    void write_burst(uint32_t addr, const uint32_t* data, size_t words) {
+        for (size_t i = 0; i < words; i++) write(addr + 4 * (uint32_t)i, data[i]);
+    }
+
+    // Queue a read. Returns the ticket to collect the data with.
+    uint32_t read(uint32_t addr) {
+        Request r = {addr & ~0x3u, 0, 0xF, false, next_ticket_};
+        queue_.push_back(r);
+        return next_ticket_++;
+    }
+
+    // Queue `words` reads; tickets are consecutive from the one returned
+    uint32_t read_burst(uint32_t addr, size_t words) {
+        uint32_t first = next_ticket_;
+        for (size_t i = 0; i < words; i++) read(addr + 4 * (uint32_t)i);
+        return first;
+    }
+
+    // Collect the data of a finished read. The ticket is released.
+    bool read_result(uint32_t ticket, uint32_t& data) {
+        auto it = results_.find(ticket);
+        if (it == results_.end()) return false;
+        data = it->second;
+        results_.erase(it);
+        return true;
+    }
+
+    // Nothing left to issue and every response received
+    bool idle() const { return queue_.empty() && outstanding_.empty(); }
+    size_t queued() const { return queue_.size(); }
+
+    // One bus cycle. `gnt`, `r_valid` and `r_rdata` are the values of the
+    // cycle that is ending; the returned pins are presented in the next one.
+    Pins cycle(bool gnt, bool r_valid, uint32_t r_rdata) {
+        if (!idle()) busy_cycles_++;
+        // A response belongs to a request granted in an earlier cycle
+        if (r_valid && !outstanding_.empty()) {
+            const Request& r = outstanding_.front();
+            if (!r.write) results_[r.ticket] = r_rdata;
+            outstanding_.pop_front();
+            responses_++;
+        }
+        if (presented_ && gnt && !queue_.empty()) {
+            outstanding_.push_back(queue_.front());
+            queue_.pop_front();
+            granted_++;
+        }
+        Pins p = {false, 0, true, 0, 0xF};
+        if (!queue_.empty()) {
+            const Request& r = queue_.front();
+            p.req = true;
+            p.add = r.addr;
+            p.wen = !r.write;
+            p.wdata = r.wdata;
+            p.be = r.be;
+        }
+        presented_ = p.req;
+        return p;
+    }
+
+    uint64_t granted() const { return granted_; }
+    uint64_t responses() const { return responses_; }
+    uint64_t busy_cycles() const { return busy_cycles_; }
+
+private:
+    struct Request {
+        uint32_t addr;
+        uint32_t wdata;
+        uint8_t be;
+        bool write;
+        uint32_t ticket;
+    };
+
+    std::deque<Request> queue_;        // Not granted yet, front is on the bus
+    std::deque<Request> outstanding_;  // Granted, waiting for r_valid
+    std::unordered_map<uint32_t, uint32_t> results_;
+    uint32_t next_ticket_;
+    bool presented_;                   // A request was on the bus this cycle
+    uint64_t granted_;
+    uint64_t responses_;
+    uint64_t busy_cycles_;
+};
+
+#endif // DEBUG_BUS_TRANSACTOR_H
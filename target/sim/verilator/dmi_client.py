@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""
+Client for the harness DMI server (+dmi_server=<port>, see dmi_server.h).
+
+Talks to the RISC-V debug module one DMI register access at a time, but sends
+whole batches before reading the responses back, so a memory load through
+system bus access costs one round trip per batch rather than one per access.
+
+Examples:
+  dmi_client.py --port 4444 halt regs
+  dmi_client.py --port 4444 load-bin app.bin 0x1c008000 resume
+  dmi_client.py --port 4444 dump 0x1c008000 16 quit
+"""
+import argparse
+import socket
+import struct
+import sys
+
+OP_NOP, OP_READ, OP_WRITE, OP_QUIT = 0, 1, 2, 0x80
+
+# Debug module registers (RISC-V debug spec 0.13)
+DATA0 = 0x04
+DMCONTROL = 0x10
+DMSTATUS = 0x11
+ABSTRACTCS = 0x16
+COMMAND = 0x17
+SBCS = 0x38
+SBADDRESS0 = 0x39
+SBDATA0 = 0x3C
+
+DMCONTROL_DMACTIVE = 1 << 0
+DMCONTROL_RESUMEREQ = 1 << 30
+DMCONTROL_HALTREQ = 1 << 31
+DMSTATUS_ALLHALTED = 1 << 9
+DMSTATUS_ALLRESUMEACK = 1 << 17
+ABSTRACTCS_BUSY = 1 << 12
+SBCS_SBACCESS32 = 2 << 17
+SBCS_SBAUTOINCREMENT = 1 << 16
+SBCS_SBREADONDATA = 1 << 15
+SBCS_SBREADONADDR = 1 << 20
+SBCS_SBBUSYERROR = 1 << 22
+SBCS_SBERROR = 7 << 12
+
+# Abstract register numbers
+REG_GPR0 = 0x1000
+REG_DPC = 0x7B1
+
+BATCH = 4096
+
+
+class DmiError(Exception):
+    pass
+
+
+class DmiClient:
+    def __init__(self, host, port):
+        self.sock = socket.create_connection((host, port))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    def close(self):
+        self.sock.close()
+
+    def batch(self, ops):
+        """Run a list of (op, addr, data) and return the data of each."""
+        results = []
+        for start in range(0, len(ops), BATCH):
+            chunk = ops[start:start + BATCH]
+            self.sock.sendall(b''.join(struct.pack('<BBHI', op, addr, 0, data & 0xFFFFFFFF)
+                                       for op, addr, data in chunk))
+            raw = self._recv(8 * len(chunk))
+            for i, (op, addr, _) in enumerate(chunk):
+                resp, _, _, data = struct.unpack_from('<BBHI', raw, 8 * i)
+                if resp != 0:
+                    raise DmiError('DMI %s of 0x%02x failed' % ('read' if op == OP_READ else 'write', addr))
+                results.append(data)
+        return results
+
+    def _recv(self, size):
+        buf = bytearray()
+        while len(buf) < size:
+            part = self.sock.recv(size - len(buf))
+            if not part:
+                raise DmiError('DMI server closed the connection')
+            buf += part
+        return bytes(buf)
+
+    def read(self, addr):
+        return self.batch([(OP_READ, addr, 0)])[0]
+
+    def write(self, addr, data):
+        self.batch([(OP_WRITE, addr, data)])
+
+    def quit(self, code=0):
+        self.sock.sendall(struct.pack('<BBHI', OP_QUIT, 0, 0, code))
+
+    # Run control
+
+    def wait(self, addr, mask, tries=1000):
+        for _ in range(tries):
+            value = self.read(addr)
+            if value & mask:
+                return value
+        raise DmiError('timeout waiting for DMI 0x%02x & 0x%08x' % (addr, mask))
+
+    def halt(self):
+        self.write(DMCONTROL, DMCONTROL_DMACTIVE)
+        self.write(DMCONTROL, DMCONTROL_DMACTIVE | DMCONTROL_HALTREQ)
+        self.wait(DMSTATUS, DMSTATUS_ALLHALTED)
+        self.write(DMCONTROL, DMCONTROL_DMACTIVE)
+
+    def resume(self):
+        self.write(DMCONTROL, DMCONTROL_DMACTIVE | DMCONTROL_RESUMEREQ)
+        self.wait(DMSTATUS, DMSTATUS_ALLRESUMEACK)
+        self.write(DMCONTROL, DMCONTROL_DMACTIVE)
+
+    def read_reg(self, regno):
+        # Access register, 32 bits, transfer
+        self.write(COMMAND, (2 << 20) | (1 << 17) | regno)
+        status = self.read(ABSTRACTCS)
+        while status & ABSTRACTCS_BUSY:
+            status = self.read(ABSTRACTCS)
+        if (status >> 8) & 0x7:
+            self.write(ABSTRACTCS, 0x7 << 8)
+            raise DmiError('abstract command for register 0x%x failed' % regno)
+        return self.read(DATA0)
+
+    def write_reg(self, regno, value):
+        self.batch([(OP_WRITE, DATA0, value),
+                    (OP_WRITE, COMMAND, (2 << 20) | (1 << 17) | (1 << 16) | regno)])
+        status = self.read(ABSTRACTCS)
+        while status & ABSTRACTCS_BUSY:
+            status = self.read(ABSTRACTCS)
+        if (status >> 8) & 0x7:
+            self.write(ABSTRACTCS, 0x7 << 8)
+            raise DmiError('abstract command for register 0x%x failed' % regno)
+
+    # Memory through system bus access. The core keeps running.
+
+    def _check_sb(self):
+        sbcs = self.read(SBCS)
+        if sbcs & (SBCS_SBBUSYERROR | SBCS_SBERROR):
+            self.write(SBCS, SBCS_SBBUSYERROR | SBCS_SBERROR)
+            raise DmiError('system bus error (sbcs 0x%08x)' % sbcs)
+
+    def write_mem(self, addr, words):
+        ops = [(OP_WRITE, SBCS, SBCS_SBACCESS32 | SBCS_SBAUTOINCREMENT),
+               (OP_WRITE, SBADDRESS0, addr)]
+        ops += [(OP_WRITE, SBDATA0, w) for w in words]
+        self.batch(ops)
+        self._check_sb()
+
+    def read_mem(self, addr, count):
+        ops = [(OP_WRITE, SBCS, SBCS_SBACCESS32 | SBCS_SBAUTOINCREMENT |
+                SBCS_SBREADONADDR | SBCS_SBREADONDATA),
+               (OP_WRITE, SBADDRESS0, addr)]
+        ops += [(OP_READ, SBDATA0, 0)] * count
+        data = self.batch(ops)[2:]
+        self._check_sb()
+        return data
+
+
+def to_words(blob):
+    blob += b'\0' * (-len(blob) % 4)
+    return list(struct.unpack('<%dI' % (len(blob) // 4), blob))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--host', default='localhost')
+    parser.add_argument('--port', type=int, required=True)
+    parser.add_argument('commands', nargs='+',
+                        help='halt | resume | regs | dump <addr> <words> | load-bin <file> <addr> | '
+                             'dmi <addr> [value] | quit [code]')
+    args = parser.parse_args()
+
+    client = DmiClient(args.host, args.port)
+    cmds = list(args.commands)
+    try:
+        while cmds:
+            cmd = cmds.pop(0)
+            if cmd == 'halt':
+                client.halt()
+                print('halted at 0x%08x' % client.read_reg(REG_DPC))
+            elif cmd == 'resume':
+                client.resume()
+            elif cmd == 'regs':
+                for i in range(32):
+                    print('x%-2d 0x%08x' % (i, client.read_reg(REG_GPR0 + i)))
+                print('pc  0x%08x' % client.read_reg(REG_DPC))
+            elif cmd == 'dump':
+                addr, count = int(cmds.pop(0), 0), int(cmds.pop(0), 0)
+                for i, w in enumerate(client.read_mem(addr, count)):
+                    print('0x%08x: 0x%08x' % (addr + 4 * i, w))
+            elif cmd == 'load-bin':
+                path, addr = cmds.pop(0), int(cmds.pop(0), 0)
+                with open(path, 'rb') as f:
+                    words = to_words(f.read())
+                client.write_mem(addr, words)
+                print('loaded %d words at 0x%08x' % (len(words), addr))
+            elif cmd == 'dmi':
+                addr = int(cmds.pop(0), 0)
+                if cmds and cmds[0][0].isdigit():
+                    client.write(addr, int(cmds.pop(0), 0))
+                else:
+                    print('0x%08x' % client.read(addr))
+            elif cmd == 'quit':
+                code = int(cmds.pop(0), 0) if cmds and cmds[0].isdigit() else 0
+                client.quit(code)
+            else:
+                parser.error('unknown command %s' % cmd)
+    except DmiError as e:
+        print('error: %s' % e, file=sys.stderr)
+        return 1
+    finally:
+        client.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
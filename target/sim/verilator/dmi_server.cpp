@@ -0,0 +1,153 @@
+// Copyright 2025 Custom IP Integration
+// TCP endpoint for debug module interface (DMI) accesses.
+
+#include "dmi_server.h"
+#include "tb_console.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const size_t FRAME_BYTES = 8;
+
+static uint32_t get_le32(const char* p) {
+    const unsigned char* u = (const unsigned char*)p;
+    return u[0] | (u[1] << 8) | (u[2] << 16) | ((uint32_t)u[3] << 24);
+}
+
+DmiServer::DmiServer()
+    : listen_fd_(-1), client_fd_(-1), port_(0), countdown_(0), quiet_ticks_(0),
+      quit_(false), exit_code_(0), served_(0) {}
+
+DmiServer::~DmiServer() {
+    drop_client();
+    if (listen_fd_ >= 0) close(listen_fd_);
+}
+
+bool DmiServer::listen(int port) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        tb_err() << "DMI server: socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 1) < 0) {
+        tb_err() << "DMI server: cannot listen on port " << port << ": " << strerror(errno) << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    fcntl(listen_fd_, F_SETFL, O_NONBLOCK);
+
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, (struct sockaddr*)&addr, &len);
+    port_ = ntohs(addr.sin_port);
+    return true;
+}
+
+void DmiServer::tick() {
+    // The DTM is still working through earlier requests
+    if (!requests_.empty()) return;
+    if (!out_.empty()) flush();
+    if (countdown_ > 0) {
+        countdown_--;
+        return;
+    }
+    if (listen_fd_ < 0) return;
+
+    size_t before = served_;
+    if (client_fd_ < 0) accept_client();
+    if (client_fd_ >= 0) receive();
+    if (served_ != before) {
+        quiet_ticks_ = 0;
+    } else {
+        quiet_ticks_ += countdown_ + 1;
+    }
+    // Poll every tick while a debugger is talking, back off once it is quiet
+    countdown_ = (client_fd_ >= 0 && quiet_ticks_ < ACTIVE_TICKS) ? 0 : IDLE_POLL_TICKS;
+}
+
+void DmiServer::respond(uint8_t resp, uint8_t addr, uint32_t data) {
+    if (client_fd_ < 0) return;
+    char frame[FRAME_BYTES] = {(char)resp, (char)addr, 0, 0,
+                               (char)data, (char)(data >> 8), (char)(data >> 16), (char)(data >> 24)};
+    out_.append(frame, FRAME_BYTES);
+    // Do not let a long pipelined burst pile up responses
+    if (out_.size() >= 64 * 1024) flush();
+}
+
+void DmiServer::accept_client() {
+    client_fd_ = accept(listen_fd_, nullptr, nullptr);
+    if (client_fd_ < 0) return;
+    fcntl(client_fd_, F_SETFL, O_NONBLOCK);
+    int nodelay = 1;
+    setsockopt(client_fd_, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    quiet_ticks_ = 0;
+    tb_out() << "DMI server: client connected" << std::endl;
+}
+
+void DmiServer::receive() {
+    char buf[16 * 1024];
+    for (;;) {
+        ssize_t n = recv(client_fd_, buf, sizeof(buf), 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            tb_out() << "DMI server: client disconnected" << std::endl;
+            drop_client();
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        in_.append(buf, (size_t)n);
+        if ((size_t)n < sizeof(buf)) break;
+    }
+
+    size_t pos = 0;
+    for (; pos + FRAME_BYTES <= in_.size(); pos += FRAME_BYTES) {
+        const char* f = in_.data() + pos;
+        Request r = {(uint8_t)f[0], (uint8_t)f[1], get_le32(f + 4)};
+        served_++;
+        if (r.op == OP_QUIT) {
+            quit_ = true;
+            exit_code_ = (int)r.data;
+            continue;
+        }
+        requests_.push_back(r);
+    }
+    in_.erase(0, pos);
+}
+
+void DmiServer::flush() {
+    while (!out_.empty() && client_fd_ >= 0) {
+        ssize_t n = send(client_fd_, out_.data(), out_.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) drop_client();
+            return;
+        }
+        out_.erase(0, (size_t)n);
+    }
+}
+
+void DmiServer::drop_client() {
+    if (client_fd_ >= 0) close(client_fd_);
+    client_fd_ = -1;
+    requests_.clear();
+    in_.clear();
+    out_.clear();
+}
@@ -0,0 +1,103 @@
+// Copyright 2025 Custom IP Integration
+// TCP endpoint for debug module interface (DMI) accesses.
+//
+// A debugger-side client sends DMI operations as fixed 8-byte frames and
+// gets one 8-byte response per read, write or nop, in order. Frames are
+// little-endian:
+//
+//   request:  op[7:0] addr[15:8] reserved[31:16] data[63:32]
+//   response: resp[7:0] addr[15:8] reserved[31:16] data[63:32]
+//
+// op follows the DMI encoding (0 nop, 1 read, 2 write); OP_QUIT ends the
+// simulation with `data` as exit code. resp is the DMI status (0 ok,
+// 2 failed). A client may send any number of requests without waiting, so a
+// memory load through system bus access costs one socket write per batch
+// instead of one round trip per JTAG bit as with remote_bitbang.
+//
+// The server never blocks the simulation. tick() is called once per clock;
+// it polls the socket on every call while a client is active and only every
+// IDLE_POLL_TICKS once traffic has stopped, so an attached but quiet
+// debugger costs next to nothing.
+
+#ifndef DMI_SERVER_H
+#define DMI_SERVER_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+// Where a DMI transport (JtagDtm, SimDTM) takes its operations from and
+// sends the responses to, in request order
+class DmiHost {
+public:
+    enum Op { OP_NOP = 0, OP_READ = 1, OP_WRITE = 2, OP_QUIT = 0x80 };
+    enum Resp { RESP_OK = 0, RESP_FAILED = 2 };
+
+    struct Request {
+        uint8_t op;
+        uint8_t addr;
+        uint32_t data;
+    };
+
+    virtual ~DmiHost() {}
+
+    // Called by the transport once per clock while it has nothing to do
+    virtual void tick() {}
+
+    virtual bool pending() const = 0;
+    virtual const Request& front() const = 0;
+    virtual void pop() = 0;
+
+    // Answer the oldest request not answered yet
+    virtual void respond(uint8_t resp, uint8_t addr, uint32_t data) = 0;
+
+    // The host wants the simulation to end
+    virtual bool quit() const { return false; }
+};
+
+class DmiServer : public DmiHost {
+public:
+    static const uint64_t IDLE_POLL_TICKS = 1024;  // Poll interval of a quiet server
+    static const uint64_t ACTIVE_TICKS = 100000;   // Quiet ticks before backing off
+
+    DmiServer();
+    ~DmiServer();
+
+    // Listen on `port` (0 = any free port). Returns false on error.
+    bool listen(int port);
+    int port() const { return port_; }
+
+    // Accept a client, read requests and send buffered responses
+    void tick() override;
+
+    bool pending() const override { return !requests_.empty(); }
+    const Request& front() const override { return requests_.front(); }
+    void pop() override { requests_.pop_front(); }
+    void respond(uint8_t resp, uint8_t addr, uint32_t data) override;
+
+    bool connected() const { return client_fd_ >= 0; }
+    bool quit() const override { return quit_; }
+    int exit_code() const { return exit_code_; }
+
+    uint64_t requests_served() const { return served_; }
+
+private:
+    void accept_client();
+    void receive();
+    void flush();
+    void drop_client();
+
+    int listen_fd_;
+    int client_fd_;
+    int port_;
+    std::deque<Request> requests_;
+    std::string in_;                 // Partial request frame
+    std::string out_;                // Responses not sent yet
+    uint64_t countdown_;             // Ticks to the next poll
+    uint64_t quiet_ticks_;           // Ticks since the last request
+    bool quit_;
+    int exit_code_;
+    uint64_t served_;
+};
+
+#endif // DMI_SERVER_H
@@ -0,0 +1,159 @@
+// Copyright 2025 Custom IP Integration
+// Minimal ELF32 reader for the Verilator harness.
+
+#include "elf_loader.h"
+#include "tb_console.h"
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifndef EM_RISCV
+#define EM_RISCV 243
+#endif
+
+ElfImage::ElfImage() : fd_(-1), base_(nullptr), size_(0), entry_(0) {}
+
+ElfImage::~ElfImage() {
+    close();
+}
+
+void ElfImage::close() {
+    if (base_) {
+        munmap(const_cast<uint8_t*>(base_), size_);
+        base_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    segments_.clear();
+    symbols_.clear();
+}
+
+bool ElfImage::open(const std::string& filename) {
+    close();
+
+    fd_ = ::open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        tb_err() << "Error: Cannot open ELF file: " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || st.st_size < (off_t)sizeof(Elf32_Ehdr)) {
+        tb_err() << "Error: " << filename << " is too small to be an ELF file" << std::endl;
+        close();
+        return false;
+    }
+    size_ = st.st_size;
+    void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (p == MAP_FAILED) {
+        tb_err() << "Error: Cannot mmap ELF file: " << filename << std::endl;
+        base_ = nullptr;
+        close();
+        return false;
+    }
+    base_ = static_cast<const uint8_t*>(p);
+
+    if (!parse()) {
+        tb_err() << "Error: " << filename << " is not a little-endian RISC-V ELF32 executable" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ElfImage::parse() {
+    const Elf32_Ehdr* eh = reinterpret_cast<const Elf32_Ehdr*>(base_);
+    if (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh->e_ident[EI_CLASS] != ELFCLASS32 ||
+        eh->e_ident[EI_DATA] != ELFDATA2LSB ||
+        eh->e_machine != EM_RISCV) {
+        return false;
+    }
+    entry_ = eh->e_entry;
+
+    if ((size_t)eh->e_phoff + (size_t)eh->e_phnum * sizeof(Elf32_Phdr) > size_) {
+        return false;
+    }
+    const Elf32_Phdr* ph = reinterpret_cast<const Elf32_Phdr*>(base_ + eh->e_phoff);
+    for (int i = 0; i < eh->e_phnum; i++) {
+        if (ph[i].p_type != PT_LOAD || ph[i].p_memsz == 0) continue;
+        if ((size_t)ph[i].p_offset + ph[i].p_filesz > size_) return false;
+        if (ph[i].p_filesz > ph[i].p_memsz) {
+            tb_err() << "Error: Segment " << i << " has " << ph[i].p_filesz << " file bytes but only "
+                     << ph[i].p_memsz << " bytes in memory" << std::endl;
+            return false;
+        }
+        Segment seg;
+        seg.paddr = ph[i].p_paddr;
+        seg.vaddr = ph[i].p_vaddr;
+        seg.data = base_ + ph[i].p_offset;
+        seg.filesz = ph[i].p_filesz;
+        seg.memsz = ph[i].p_memsz;
+        seg.flags = ph[i].p_flags;
+        segments_.push_back(seg);
+    }
+
+    parse_symbols();
+    return true;
+}
+
+void ElfImage::parse_symbols() {
+    const Elf32_Ehdr* eh = reinterpret_cast<const Elf32_Ehdr*>(base_);
+    if (eh->e_shoff == 0 ||
+        (size_t)eh->e_shoff + (size_t)eh->e_shnum * sizeof(Elf32_Shdr) > size_) {
+        return; // Stripped or truncated: no symbols, loading still works
+    }
+    const Elf32_Shdr* sh = reinterpret_cast<const Elf32_Shdr*>(base_ + eh->e_shoff);
+    for (int i = 0; i < eh->e_shnum; i++) {
+        if (sh[i].sh_type != SHT_SYMTAB || sh[i].sh_link >= eh->e_shnum) continue;
+        const Elf32_Shdr& strtab = sh[sh[i].sh_link];
+        if ((size_t)sh[i].sh_offset + sh[i].sh_size > size_ ||
+            (size_t)strtab.sh_offset + strtab.sh_size > size_) {
+            continue;
+        }
+        const Elf32_Sym* sym = reinterpret_cast<const Elf32_Sym*>(base_ + sh[i].sh_offset);
+        const char* names = reinterpret_cast<const char*>(base_ + strtab.sh_offset);
+        size_t count = sh[i].sh_size / sizeof(Elf32_Sym);
+        for (size_t j = 0; j < count; j++) {
+            uint8_t type = ELF32_ST_TYPE(sym[j].st_info);
+            if (type != STT_FUNC && type != STT_OBJECT && type != STT_NOTYPE) continue;
+            if (sym[j].st_name == 0 || sym[j].st_name >= strtab.sh_size) continue;
+            if (sym[j].st_shndx == SHN_UNDEF) continue;
+            Symbol s;
+            // The string table need not end in a NUL
+            s.name.assign(names + sym[j].st_name, strnlen(names + sym[j].st_name, strtab.sh_size - sym[j].st_name));
+            s.addr = sym[j].st_value;
+            s.size = sym[j].st_size;
+            s.type = type;
+            symbols_.push_back(s);
+        }
+    }
+    std::stable_sort(symbols_.begin(), symbols_.end(),
+                     [](const Symbol& a, const Symbol& b) { return a.addr < b.addr; });
+}
+
+const ElfImage::Symbol* ElfImage::find_symbol(const std::string& name) const {
+    for (const Symbol& s : symbols_) {
+        if (s.name == name) return &s;
+    }
+    return nullptr;
+}
+
+const ElfImage::Symbol* ElfImage::symbol_at(uint32_t addr) const {
+    auto it = std::upper_bound(symbols_.begin(), symbols_.end(), addr,
+                               [](uint32_t a, const Symbol& s) { return a < s.addr; });
+    // Walk back over zero-sized labels to the closest sized symbol
+    while (it != symbols_.begin()) {
+        --it;
+        if (it->size == 0 && it->type == STT_NOTYPE) continue;
+        if (it->size == 0 || addr < it->addr + it->size) return &*it;
+        return nullptr;
+    }
+    return nullptr;
+}
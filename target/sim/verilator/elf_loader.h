@@ -0,0 +1,67 @@
+// Copyright 2025 Custom IP Integration
+// Minimal ELF32 reader for the Verilator harness.
+//
+// The file is mmap'ed read-only and kept mapped for the lifetime of the
+// object: segments point straight into the mapping, so placing a segment in
+// memory is a single contiguous copy and no intermediate buffers are built.
+
+#ifndef ELF_LOADER_H
+#define ELF_LOADER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ElfImage {
+public:
+    struct Segment {
+        uint32_t paddr;      // Load address (LMA)
+        uint32_t vaddr;      // Run address (VMA)
+        const uint8_t* data; // File contents, inside the mapping
+        uint32_t filesz;
+        uint32_t memsz;      // memsz > filesz is zero-filled (.bss)
+        uint32_t flags;      // PF_R / PF_W / PF_X
+    };
+
+    struct Symbol {
+        std::string name;
+        uint32_t addr;
+        uint32_t size;
+        uint8_t type;        // STT_FUNC, STT_OBJECT, ...
+    };
+
+    ElfImage();
+    ~ElfImage();
+    ElfImage(const ElfImage&) = delete;
+    ElfImage& operator=(const ElfImage&) = delete;
+
+    // Map and parse `filename`. Returns false and prints the reason on error.
+    bool open(const std::string& filename);
+
+    uint32_t entry() const { return entry_; }
+    const std::vector<Segment>& segments() const { return segments_; }
+
+    // Symbols sorted by address
+    const std::vector<Symbol>& symbols() const { return symbols_; }
+
+    // Look up a symbol by name. Returns nullptr if it does not exist.
+    const Symbol* find_symbol(const std::string& name) const;
+
+    // Return the function or object containing `addr`, or nullptr
+    const Symbol* symbol_at(uint32_t addr) const;
+
+private:
+    void close();
+    bool parse();
+    void parse_symbols();
+
+    int fd_;
+    const uint8_t* base_;
+    size_t size_;
+    uint32_t entry_;
+    std::vector<Segment> segments_;
+    std::vector<Symbol> symbols_;
+};
+
+#endif // ELF_LOADER_H
@@ -0,0 +1,693 @@
+// Copyright 2025 Custom IP Integration
+// GDB remote serial protocol server built into the harness.
+
+#include "gdb_server.h"
+#include "tb_console.h"
+#include "tb_hier.h"
+
+#include <arpa/inet.h>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Debug module registers (RISC-V debug spec 0.13)
+static const uint8_t DM_DATA0 = 0x04;
+static const uint8_t DM_DMCONTROL = 0x10;
+static const uint8_t DM_DMSTATUS = 0x11;
+static const uint8_t DM_ABSTRACTCS = 0x16;
+static const uint8_t DM_COMMAND = 0x17;
+static const uint8_t DM_SBCS = 0x38;
+static const uint8_t DM_SBADDRESS0 = 0x39;
+static const uint8_t DM_SBDATA0 = 0x3C;
+
+static const uint32_t DMCONTROL_DMACTIVE = 1u << 0;
+static const uint32_t DMCONTROL_RESUMEREQ = 1u << 30;
+static const uint32_t DMCONTROL_HALTREQ = 1u << 31;
+static const uint32_t DMSTATUS_ALLHALTED = 1u << 9;
+static const uint32_t DMSTATUS_ALLRESUMEACK = 1u << 17;
+static const uint32_t ABSTRACTCS_BUSY = 1u << 12;
+static const uint32_t ABSTRACTCS_CMDERR = 7u << 8;
+static const uint32_t SBCS_SBACCESS8 = 0u << 17;
+static const uint32_t SBCS_SBACCESS32 = 2u << 17;
+static const uint32_t SBCS_SBAUTOINCREMENT = 1u << 16;
+static const uint32_t SBCS_SBREADONADDR = 1u << 20;
+static const uint32_t SBCS_ERRORS = (1u << 22) | (7u << 12);
+
+// Access register command: 32 bits, transfer, optionally write
+static uint32_t access_reg(uint32_t regno, bool write) {
+    return (2u << 20) | (1u << 17) | (write ? 1u << 16 : 0) | regno;
+}
+static const uint32_t REG_GPR0 = 0x1000;
+static const uint32_t REG_DCSR = 0x7B0;
+static const uint32_t REG_DPC = 0x7B1;
+static const uint32_t DCSR_STEP = 1u << 2;
+static const uint32_t DCSR_EBREAKM = 1u << 15;
+
+static const unsigned NUM_REGS = 33;  // x0-x31, pc
+static const int POLL_TRIES = 100;    // dmstatus reads before giving up
+
+// PacketSize in the qSupported reply. An 'm' reply takes two hex digits per
+// byte, so longer reads are refused.
+static const uint32_t PACKET_SIZE = 0x4000;
+static const uint32_t MAX_READ_BYTES = PACKET_SIZE / 2;
+
+static const char* const REG_NAMES[32] = {
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2", "fp", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+    "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"};
+
+static std::string target_xml() {
+    std::string xml =
+        "<?xml version=\"1.0\"?><!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+        "<target version=\"1.0\"><architecture>riscv:rv32</architecture>"
+        "<feature name=\"org.gnu.gdb.riscv.cpu\">";
+    for (int i = 0; i < 32; i++) {
+        xml += std::string("<reg name=\"") + REG_NAMES[i] + "\" bitsize=\"32\" type=\"" +
+               (i == 1 ? "code_ptr" : (i == 2 || i == 8) ? "data_ptr" : "int") + "\"/>";
+    }
+    xml += "<reg name=\"pc\" bitsize=\"32\" type=\"code_ptr\"/></feature></target>";
+    return xml;
+}
+
+static std::string hex_le32(uint32_t v) {
+    char buf[9];
+    snprintf(buf, sizeof(buf), "%02x%02x%02x%02x", v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, v >> 24);
+    return buf;
+}
+
+// Whole of `s` as a hex number; false if it is empty, has other characters
+// or does not fit in 32 bits
+static bool parse_hex(const std::string& s, uint32_t& v) {
+    if (s.empty() || !isxdigit((unsigned char)s[0])) return false;
+    char* end;
+    errno = 0;
+    unsigned long n = strtoul(s.c_str(), &end, 16);
+    if (*end != '\0' || errno == ERANGE || n > 0xFFFFFFFFul) return false;
+    v = (uint32_t)n;
+    return true;
+}
+
+static bool parse_le32(const std::string& s, size_t pos, uint32_t& v) {
+    if (s.size() < pos + 8) return false;
+    v = 0;
+    for (int i = 0; i < 4; i++) {
+        uint32_t byte;
+        if (!parse_hex(s.substr(pos + 2 * i, 2), byte)) return false;
+        v |= byte << (8 * i);
+    }
+    return true;
+}
+
+GdbServer::GdbServer(Vpulpissimo* top, ClockScheduler& sched, uint32_t rom_base, uint32_t rom_size,
+                     uint32_t l2_base)
+    : top_(top), sched_(sched), dtm_(top, this), l2_(top), rom_base_(rom_base), rom_size_(rom_size),
+      l2_base_(l2_base), listen_fd_(-1), client_fd_(-1), port_(0), no_ack_(false), detached_(false),
+      kill_(false), stopped_(false), signal_(5), running_(false), resuming_(false),
+      entered_debug_(false), next_poll_(0), dmi_broken_(false), packets_(0) {}
+
+GdbServer::~GdbServer() {
+    drop_client();
+    if (listen_fd_ >= 0) close(listen_fd_);
+}
+
+bool GdbServer::listen(int port) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return false;
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(listen_fd_, 1) < 0) {
+        tb_err() << "GDB server: cannot listen on port " << port << ": " << strerror(errno) << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, (struct sockaddr*)&addr, &len);
+    port_ = ntohs(addr.sin_port);
+    return true;
+}
+
+void GdbServer::sample(uint64_t) {
+    if (running_) watch_pc();
+}
+
+// The core is in debug mode while it executes from the debug module
+void GdbServer::watch_pc() {
+    bool in_dm = TB_FC_CORE_SIG(top_, pc_id) - DM_BASE < DM_SIZE;
+    if (resuming_) {
+        if (!in_dm) resuming_ = false;
+    } else if (in_dm) {
+        running_ = false;
+        entered_debug_ = true;
+    }
+}
+
+void GdbServer::service(uint64_t cycle) {
+    if (client_fd_ < 0) {
+        if (detached_ || listen_fd_ < 0 || !wait_for_client()) return;
+        if (!halt()) {
+            tb_err() << "GDB server: cannot halt the core through the debug module" << std::endl;
+        }
+        stopped_ = true;
+        signal_ = 5;
+    }
+
+    if (!stopped_) {
+        std::string packet;
+        if (entered_debug_) {
+            entered_debug_ = false;
+            stopped_ = true;
+            signal_ = 5;
+            send_stop_reply();
+        } else if (cycle >= next_poll_) {
+            next_poll_ = cycle + POLL_CYCLES;
+            if (read_packet(packet, false) && packet == "\x03") {
+                halt();
+                stopped_ = true;
+                signal_ = 2;
+                send_stop_reply();
+            }
+        }
+    }
+
+    // The simulation only moves on when GDB resumes the core
+    while (stopped_ && client_fd_ >= 0 && !kill_) {
+        std::string packet;
+        if (!read_packet(packet, true)) break;
+        handle(packet);
+        // A step can finish before control returns to the main loop
+        if (!stopped_ && entered_debug_) {
+            entered_debug_ = false;
+            stopped_ = true;
+            signal_ = 5;
+            send_stop_reply();
+        }
+    }
+}
+
+void GdbServer::finish(int exit_status) {
+    if (client_fd_ < 0) return;
+    char buf[8];
+    snprintf(buf, sizeof(buf), "W%02x", exit_status & 0xFF);
+    send_packet(buf);
+    drop_client();
+}
+
+bool GdbServer::wait_for_client() {
+    tb_out() << "GDB server: waiting for a connection on port " << port_ << std::endl;
+    client_fd_ = accept(listen_fd_, nullptr, nullptr);
+    if (client_fd_ < 0) return false;
+    int nodelay = 1;
+    setsockopt(client_fd_, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    tb_out() << "GDB server: connected at cycle " << sched_.get_cycle() << std::endl;
+    return true;
+}
+
+// Take out the breakpoints and let the program run on without GDB
+void GdbServer::detach() {
+    while (!breakpoints_.empty()) remove_breakpoint(breakpoints_.begin()->first);
+    if (stopped_) resume(false);
+    stopped_ = false;
+    running_ = false;
+    drop_client();
+    detached_ = true;
+}
+
+void GdbServer::drop_client() {
+    if (client_fd_ >= 0) close(client_fd_);
+    client_fd_ = -1;
+    rx_.clear();
+}
+
+// Return one packet payload, or "\x03" for an interrupt. Without `block`
+// only data already received is looked at.
+bool GdbServer::read_packet(std::string& packet, bool block) {
+    for (;;) {
+        size_t start = 0;
+        while (start < rx_.size() && rx_[start] != '$' && rx_[start] != '\x03') start++;
+        rx_.erase(0, start);
+        if (!rx_.empty() && rx_[0] == '\x03') {
+            rx_.erase(0, 1);
+            packet = "\x03";
+            return true;
+        }
+        size_t hash = rx_.find('#');
+        if (!rx_.empty() && hash != std::string::npos && hash + 2 < rx_.size()) {
+            packet = rx_.substr(1, hash - 1);
+            rx_.erase(0, hash + 3);
+            if (!no_ack_) send(client_fd_, "+", 1, MSG_NOSIGNAL);
+            packets_++;
+            return true;
+        }
+
+        struct pollfd pfd = {client_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, block ? -1 : 0) <= 0) {
+            if (block && errno == EINTR) continue;
+            return false;
+        }
+        char buf[4096];
+        ssize_t n = recv(client_fd_, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            tb_out() << "GDB server: connection closed, the program keeps running" << std::endl;
+            detach();
+            return false;
+        }
+        rx_.append(buf, (size_t)n);
+    }
+}
+
+void GdbServer::send_packet(const std::string& payload) {
+    if (client_fd_ < 0) return;
+    uint8_t sum = 0;
+    for (char c : payload) sum += (uint8_t)c;
+    char tail[4];
+    snprintf(tail, sizeof(tail), "#%02x", sum);
+    std::string frame = "$" + payload + tail;
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = send(client_fd_, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            drop_client();
+            return;
+        }
+        sent += (size_t)n;
+    }
+}
+
+void GdbServer::send_stop_reply() {
+    char buf[8];
+    snprintf(buf, sizeof(buf), "S%02x", signal_);
+    send_packet(buf);
+}
+
+void GdbServer::handle(const std::string& packet) {
+    if (packet.empty()) return send_packet("");
+    char cmd = packet[0];
+    std::string args = packet.substr(1);
+
+    switch (cmd) {
+    case '\x03':
+        return send_stop_reply();  // Already halted
+    case '?':
+        return send_stop_reply();
+    case 'g': {
+        std::vector<uint32_t> regs;
+        if (!read_regs(REG_GPR0, 32, regs)) return send_packet("E01");
+        uint32_t pc = 0;
+        if (!read_reg(REG_DPC, pc)) return send_packet("E01");
+        std::string reply;
+        for (uint32_t r : regs) reply += hex_le32(r);
+        return send_packet(reply + hex_le32(pc));
+    }
+    case 'G': {
+        if (args.size() < NUM_REGS * 8) return send_packet("E01");
+        for (unsigned i = 1; i < NUM_REGS; i++) {
+            uint32_t regno = i < 32 ? REG_GPR0 + i : REG_DPC;
+            uint32_t value;
+            if (!parse_le32(args, i * 8, value) || !write_reg(regno, value)) return send_packet("E01");
+        }
+        return send_packet("OK");
+    }
+    case 'p': {
+        uint32_t n;
+        uint32_t value = 0;
+        if (!parse_hex(args, n) || n >= NUM_REGS || !read_reg(n < 32 ? REG_GPR0 + n : REG_DPC, value)) return send_packet("E01");
+        return send_packet(hex_le32(value));
+    }
+    case 'P': {
+        size_t eq = args.find('=');
+        uint32_t n, value;
+        if (eq == std::string::npos || !parse_hex(args.substr(0, eq), n) || n >= NUM_REGS ||
+            !parse_le32(args, eq + 1, value)) {
+            return send_packet("E01");
+        }
+        if (n == 0) return send_packet("OK");
+        return send_packet(write_reg(n < 32 ? REG_GPR0 + n : REG_DPC, value) ? "OK" : "E01");
+    }
+    case 'm': {
+        size_t comma = args.find(',');
+        uint32_t addr, len;
+        if (comma == std::string::npos || !parse_hex(args.substr(0, comma), addr) ||
+            !parse_hex(args.substr(comma + 1), len) || len > MAX_READ_BYTES) {
+            return send_packet("E01");
+        }
+        std::vector<uint8_t> data;
+        if (!read_memory(addr, len, data)) return send_packet("E01");
+        std::string reply;
+        char byte[3];
+        for (uint8_t b : data) {
+            snprintf(byte, sizeof(byte), "%02x", b);
+            reply += byte;
+        }
+        return send_packet(reply);
+    }
+    case 'M':
+    case 'X': {
+        size_t comma = args.find(',');
+        size_t colon = args.find(':');
+        uint32_t addr, len;
+        if (comma == std::string::npos || colon == std::string::npos || colon < comma ||
+            !parse_hex(args.substr(0, comma), addr) ||
+            !parse_hex(args.substr(comma + 1, colon - comma - 1), len) || len > args.size()) {
+            return send_packet("E01");
+        }
+        std::vector<uint8_t> data;
+        data.reserve(len);
+        for (size_t i = colon + 1; i < args.size() && data.size() < len; i++) {
+            if (cmd == 'M') {
+                uint32_t byte;
+                if (!parse_hex(args.substr(i, 2), byte) || byte > 0xFF) return send_packet("E01");
+                data.push_back((uint8_t)byte);
+                i++;
+            } else if (args[i] == '}' && i + 1 < args.size()) {
+                data.push_back((uint8_t)args[++i] ^ 0x20);
+            } else {
+                data.push_back((uint8_t)args[i]);
+            }
+        }
+        if (data.size() != len) return send_packet("E01");
+        return send_packet(write_memory(addr, data.data(), len) ? "OK" : "E01");
+    }
+    case 'c':
+    case 's': {
+        if (!args.empty()) {
+            uint32_t pc;
+            if (!parse_hex(args, pc) || !write_reg(REG_DPC, pc)) return send_packet("E01");
+        }
+        if (!resume(cmd == 's')) return send_packet("E01");
+        stopped_ = false;
+        return;  // The stop reply follows when the core halts again
+    }
+    case 'Z':
+    case 'z': {
+        // Z0 software and Z1 hardware breakpoints are both planted as ebreak
+        if (args.size() < 2 || (args[0] != '0' && args[0] != '1')) return send_packet("");
+        size_t comma = args.find(',', 2);
+        uint32_t addr, kind = 4;
+        if (!parse_hex(args.substr(2, comma - 2), addr) ||
+            (comma != std::string::npos && !parse_hex(args.substr(comma + 1), kind))) {
+            return send_packet("E01");
+        }
+        bool ok = cmd == 'Z' ? insert_breakpoint(addr, kind) : remove_breakpoint(addr);
+        return send_packet(ok ? "OK" : "E01");
+    }
+    case 'D':
+        send_packet("OK");
+        tb_out() << "GDB server: detached, the program keeps running" << std::endl;
+        detach();
+        return;
+    case 'k':
+        kill_ = true;
+        drop_client();
+        return;
+    case 'H':
+        return send_packet("OK");
+    case 'q':
+        if (packet.compare(0, 10, "qSupported") == 0) {
+            char features[64];
+            snprintf(features, sizeof(features), "PacketSize=%x;qXfer:features:read+;QStartNoAckMode+", PACKET_SIZE);
+            return send_packet(features);
+        }
+        if (packet == "qAttached") return send_packet("1");
+        if (packet == "qSymbol::") return send_packet("OK");
+        if (packet.compare(0, 31, "qXfer:features:read:target.xml:") == 0) {
+            std::string range = packet.substr(31);
+            size_t comma = range.find(',');
+            uint32_t offset, length;
+            if (comma == std::string::npos || !parse_hex(range.substr(0, comma), offset) ||
+                !parse_hex(range.substr(comma + 1), length)) {
+                return send_packet("E01");
+            }
+            static const std::string xml = target_xml();
+            if (offset >= xml.size()) return send_packet("l");
+            std::string chunk = xml.substr(offset, length);
+            return send_packet((offset + chunk.size() < xml.size() ? "m" : "l") + chunk);
+        }
+        return send_packet("");
+    case 'Q':
+        if (packet == "QStartNoAckMode") {
+            send_packet("OK");
+            no_ack_ = true;
+            return;
+        }
+        return send_packet("");
+    default:
+        return send_packet("");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Debug module
+
+void GdbServer::respond(uint8_t resp, uint8_t, uint32_t data) {
+    dmi_in_.emplace_back(resp, data);
+}
+
+// Queue `ops` for the DTM and clock the model until all are answered
+bool GdbServer::run_dmi(const std::vector<Request>& ops, std::vector<uint32_t>* results) {
+    if (dmi_broken_) return false;
+    dmi_in_.clear();
+    dmi_out_.insert(dmi_out_.end(), ops.begin(), ops.end());
+    uint64_t limit = sched_.get_cycle() + DMI_TIMEOUT_CYCLES;
+    while (dmi_in_.size() < ops.size()) {
+        if (sched_.get_cycle() > limit) {
+            tb_err() << "GDB server: debug module does not answer, giving up" << std::endl;
+            dmi_broken_ = true;
+            return false;
+        }
+        if (sched_.advance() & sched_.main_mask()) {
+            dtm_.sample(sched_.get_cycle());
+            if (running_) watch_pc();
+        }
+        top_->eval();
+    }
+    bool ok = true;
+    if (results) results->clear();
+    for (const auto& r : dmi_in_) {
+        ok &= r.first == RESP_OK;
+        if (results) results->push_back(r.second);
+    }
+    return ok;
+}
+
+bool GdbServer::dmi_read(uint8_t addr, uint32_t& data) {
+    std::vector<uint32_t> r;
+    if (!run_dmi({{OP_READ, addr, 0}}, &r)) return false;
+    data = r[0];
+    return true;
+}
+
+bool GdbServer::dmi_write(uint8_t addr, uint32_t data) {
+    return run_dmi({{OP_WRITE, addr, data}}, nullptr);
+}
+
+bool GdbServer::halt() {
+    running_ = false;
+    entered_debug_ = false;
+    if (!dmi_write(DM_DMCONTROL, DMCONTROL_DMACTIVE) ||
+        !dmi_write(DM_DMCONTROL, DMCONTROL_DMACTIVE | DMCONTROL_HALTREQ)) {
+        return false;
+    }
+    uint32_t status = 0;
+    for (int i = 0; i < POLL_TRIES && !(status & DMSTATUS_ALLHALTED); i++) {
+        if (!dmi_read(DM_DMSTATUS, status)) return false;
+    }
+    dmi_write(DM_DMCONTROL, DMCONTROL_DMACTIVE);
+    return status & DMSTATUS_ALLHALTED;
+}
+
+bool GdbServer::resume(bool step) {
+    uint32_t dcsr = 0;
+    if (!read_reg(REG_DCSR, dcsr)) return false;
+    dcsr = (dcsr & ~DCSR_STEP) | DCSR_EBREAKM | (step ? DCSR_STEP : 0);
+    if (!write_reg(REG_DCSR, dcsr)) return false;
+
+    running_ = true;
+    resuming_ = true;
+    entered_debug_ = false;
+    if (!dmi_write(DM_DMCONTROL, DMCONTROL_DMACTIVE | DMCONTROL_RESUMEREQ)) return false;
+    uint32_t status = 0;
+    for (int i = 0; i < POLL_TRIES && !(status & DMSTATUS_ALLRESUMEACK); i++) {
+        if (!dmi_read(DM_DMSTATUS, status)) return false;
+    }
+    dmi_write(DM_DMCONTROL, DMCONTROL_DMACTIVE);
+    return status & DMSTATUS_ALLRESUMEACK;
+}
+
+// Read `count` consecutive registers in one DMI batch. A register access
+// finishes long before the next DMI scan, so abstractcs is only checked
+// afterwards; on any error the registers are read one by one.
+bool GdbServer::read_regs(uint32_t first, unsigned count, std::vector<uint32_t>& values) {
+    std::vector<Request> ops;
+    for (unsigned i = 0; i < count; i++) {
+        ops.push_back({OP_WRITE, DM_COMMAND, access_reg(first + i, false)});
+        ops.push_back({OP_READ, DM_ABSTRACTCS, 0});
+        ops.push_back({OP_READ, DM_DATA0, 0});
+    }
+    std::vector<uint32_t> r;
+    bool ok = run_dmi(ops, &r);
+    values.clear();
+    for (unsigned i = 0; ok && i < count; i++) {
+        ok = !(r[3 * i + 1] & (ABSTRACTCS_BUSY | ABSTRACTCS_CMDERR));
+        values.push_back(r[3 * i + 2]);
+    }
+    if (ok) return true;
+    dmi_write(DM_ABSTRACTCS, ABSTRACTCS_CMDERR);
+    values.clear();
+    for (unsigned i = 0; i < count; i++) {
+        uint32_t v = 0;
+        if (!read_reg(first + i, v)) return false;
+        values.push_back(v);
+    }
+    return true;
+}
+
+bool GdbServer::read_reg(uint32_t regno, uint32_t& value) {
+    if (!dmi_write(DM_COMMAND, access_reg(regno, false))) return false;
+    uint32_t cs = ABSTRACTCS_BUSY;
+    for (int i = 0; i < POLL_TRIES && (cs & ABSTRACTCS_BUSY); i++) {
+        if (!dmi_read(DM_ABSTRACTCS, cs)) return false;
+    }
+    if (cs & (ABSTRACTCS_BUSY | ABSTRACTCS_CMDERR)) {
+        dmi_write(DM_ABSTRACTCS, ABSTRACTCS_CMDERR);
+        return false;
+    }
+    return dmi_read(DM_DATA0, value);
+}
+
+bool GdbServer::write_reg(uint32_t regno, uint32_t value) {
+    if (!run_dmi({{OP_WRITE, DM_DATA0, value}, {OP_WRITE, DM_COMMAND, access_reg(regno, true)}}, nullptr)) {
+        return false;
+    }
+    uint32_t cs = ABSTRACTCS_BUSY;
+    for (int i = 0; i < POLL_TRIES && (cs & ABSTRACTCS_BUSY); i++) {
+        if (!dmi_read(DM_ABSTRACTCS, cs)) return false;
+    }
+    if (cs & (ABSTRACTCS_BUSY | ABSTRACTCS_CMDERR)) {
+        dmi_write(DM_ABSTRACTCS, ABSTRACTCS_CMDERR);
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Memory
+
+uint32_t GdbServer::remap(uint32_t addr) const {
+    return addr - rom_base_ < rom_size_ ? addr - rom_base_ + l2_base_ : addr;
+}
+
+bool GdbServer::read_memory(uint32_t addr, uint32_t len, std::vector<uint8_t>& data) {
+    data.assign(len, 0);
+    std::vector<uint32_t> bus_addrs;
+    for (uint32_t word = addr & ~0x3u; word - (addr & ~0x3u) < len + (addr & 3); word += 4) {
+        uint32_t value = 0;
+        if (!l2_.read_word(remap(word), value)) {
+            bus_addrs.push_back(word);
+            continue;
+        }
+        for (int i = 0; i < 4; i++) {
+            uint32_t a = word + i;
+            if (a - addr < len) data[a - addr] = (uint8_t)(value >> (8 * i));
+        }
+    }
+    if (!bus_addrs.empty()) {
+        std::vector<uint32_t> words;
+        if (!sba_read(bus_addrs, words)) return false;
+        for (size_t w = 0; w < words.size(); w++) {
+            for (int i = 0; i < 4; i++) {
+                uint32_t a = bus_addrs[w] + i;
+                if (a - addr < len) data[a - addr] = (uint8_t)(words[w] >> (8 * i));
+            }
+        }
+    }
+    // Show the instructions under breakpoints, not the ebreaks
+    for (const auto& bp : breakpoints_) {
+        for (uint32_t i = 0; i < bp.second.kind; i++) {
+            uint32_t a = bp.first + i;
+            if (a - addr < len) data[a - addr] = bp.second.saved[i];
+        }
+    }
+    return true;
+}
+
+bool GdbServer::write_memory(uint32_t addr, const uint8_t* data, uint32_t len) {
+    uint32_t done = 0;
+    while (done < len) {
+        uint32_t a = remap(addr + done);
+        // Longest run that stays inside or outside L2
+        uint32_t run = 1;
+        bool in_l2 = L2Backdoor::contains(a);
+        while (done + run < len && L2Backdoor::contains(remap(addr + done + run)) == in_l2 &&
+               remap(addr + done + run) == a + run) {
+            run++;
+        }
+        if (in_l2) {
+            l2_.write_block(a, data + done, run);
+        } else if (!sba_write_bytes(a, data + done, run)) {
+            return false;
+        }
+        done += run;
+    }
+    return true;
+}
+
+// sbcs writes also clear the sticky error bits (write 1 to clear)
+bool GdbServer::sba_read(const std::vector<uint32_t>& addrs, std::vector<uint32_t>& words) {
+    std::vector<Request> ops = {{OP_WRITE, DM_SBCS, SBCS_SBACCESS32 | SBCS_SBREADONADDR | SBCS_ERRORS}};
+    for (uint32_t a : addrs) {
+        ops.push_back({OP_WRITE, DM_SBADDRESS0, remap(a)});
+        ops.push_back({OP_READ, DM_SBDATA0, 0});
+    }
+    ops.push_back({OP_READ, DM_SBCS, 0});
+    std::vector<uint32_t> r;
+    if (!run_dmi(ops, &r) || (r.back() & SBCS_ERRORS)) return false;
+    words.clear();
+    for (size_t i = 0; i < addrs.size(); i++) words.push_back(r[2 + 2 * i]);
+    return true;
+}
+
+bool GdbServer::sba_write_bytes(uint32_t addr, const uint8_t* data, uint32_t len) {
+    std::vector<Request> ops = {{OP_WRITE, DM_SBCS, SBCS_SBACCESS8 | SBCS_SBAUTOINCREMENT | SBCS_ERRORS},
+                                {OP_WRITE, DM_SBADDRESS0, addr}};
+    for (uint32_t i = 0; i < len; i++) ops.push_back({OP_WRITE, DM_SBDATA0, data[i]});
+    ops.push_back({OP_READ, DM_SBCS, 0});
+    std::vector<uint32_t> r;
+    return run_dmi(ops, &r) && !(r.back() & SBCS_ERRORS);
+}
+
+bool GdbServer::insert_breakpoint(uint32_t addr, uint32_t kind) {
+    if (kind != 2 && kind != 4) return false;
+    if (breakpoints_.count(addr)) return true;
+    Breakpoint bp;
+    bp.kind = kind;
+    std::vector<uint8_t> orig;
+    if (!read_memory(addr, kind, orig)) return false;
+    memcpy(bp.saved, orig.data(), kind);
+    static const uint8_t EBREAK[4] = {0x73, 0x00, 0x10, 0x00};
+    static const uint8_t C_EBREAK[2] = {0x02, 0x90};
+    if (!write_memory(addr, kind == 4 ? EBREAK : C_EBREAK, kind)) return false;
+    breakpoints_[addr] = bp;
+    return true;
+}
+
+bool GdbServer::remove_breakpoint(uint32_t addr) {
+    auto it = breakpoints_.find(addr);
+    if (it == breakpoints_.end()) return true;
+    Breakpoint bp = it->second;
+    breakpoints_.erase(it);
+    return write_memory(addr, bp.saved, bp.kind);
+}
@@ -0,0 +1,141 @@
+// Copyright 2025 Custom IP Integration
+// GDB remote serial protocol server built into the harness.
+//
+// GDB connects straight to the simulation (target remote :<port>), without
+// OpenOCD or remote_bitbang in between:
+//
+// - Memory is read and written through the L2 backdoor, so `load` runs at
+//   memory speed and costs no simulated cycles. Other addresses go through
+//   system bus access of the debug module. The boot ROM window is remapped to
+//   L2 as the ELF loader does.
+// - Halt, resume, single step and registers go through the debug module,
+//   reached over DMI by a JtagDtm on the JTAG pins. While a command needs the
+//   debug module the server clocks the model itself; those cycles are not seen
+//   by the other monitors.
+// - Breakpoints are ebreak instructions planted through the backdoor with
+//   dcsr.ebreakm set. Memory reads show the original instructions.
+// - While the core runs, the harness watches the decode PC for the core
+//   entering the debug ROM, which is how breakpoints and finished steps are
+//   noticed. A continue therefore costs one compare per cycle and a socket
+//   poll for Ctrl-C every POLL_CYCLES; no DMI traffic at all.
+//
+// The first service() call waits for GDB to connect and halts the core, so
+// breakpoints can be set before the program runs.
+
+#ifndef GDB_SERVER_H
+#define GDB_SERVER_H
+
+#include "Vpulpissimo.h"
+#include "clock_scheduler.h"
+#include "dmi_server.h"
+#include "jtag_dtm.h"
+#include "l2_backdoor.h"
+#include "sim_monitor.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+class GdbServer : public SimMonitor, public DmiHost {
+public:
+    static const uint32_t DM_BASE = 0x1A110000;       // soc_mem_map.svh DEBUG_START_ADDR
+    static const uint32_t DM_SIZE = 0x1000;
+    static const uint64_t POLL_CYCLES = 4096;         // Ctrl-C poll interval while running
+    static const uint64_t DMI_TIMEOUT_CYCLES = 2000000;
+
+    // Accesses to [rom_base, rom_base + rom_size) go to the same offset in L2
+    GdbServer(Vpulpissimo* top, ClockScheduler& sched, uint32_t rom_base, uint32_t rom_size, uint32_t l2_base);
+    ~GdbServer();
+
+    // Listen on `port` (0 = any free port). Returns false on error.
+    bool listen(int port);
+    int port() const { return port_; }
+
+    // Before each rising edge: notice the core entering debug mode
+    void sample(uint64_t cycle) override;
+    bool stop_requested() const override { return kill_; }
+
+    // After each rising edge: serve GDB while the core is halted, check for
+    // Ctrl-C while it runs
+    void service(uint64_t cycle);
+
+    // Tell an attached GDB that the program ended
+    void finish(int exit_status);
+
+    uint64_t packets() const { return packets_; }
+    uint64_t dmi_ops() const { return dtm_.dmi_ops(); }
+
+    // DmiHost for the JtagDtm
+    bool pending() const override { return !dmi_out_.empty(); }
+    const Request& front() const override { return dmi_out_.front(); }
+    void pop() override { dmi_out_.pop_front(); }
+    void respond(uint8_t resp, uint8_t addr, uint32_t data) override;
+
+private:
+    struct Breakpoint {
+        uint32_t kind;                // 2 = c.ebreak, 4 = ebreak
+        uint8_t saved[4];
+    };
+
+    // Packet layer
+    bool wait_for_client();
+    bool read_packet(std::string& packet, bool block);
+    void send_packet(const std::string& payload);
+    void detach();
+    void drop_client();
+    void handle(const std::string& packet);
+    void send_stop_reply();
+
+    // Debug module
+    bool run_dmi(const std::vector<Request>& ops, std::vector<uint32_t>* results);
+    bool dmi_read(uint8_t addr, uint32_t& data);
+    bool dmi_write(uint8_t addr, uint32_t data);
+    bool halt();
+    bool resume(bool step);
+    bool read_regs(uint32_t first, unsigned count, std::vector<uint32_t>& values);
+    bool read_reg(uint32_t regno, uint32_t& value);
+    bool write_reg(uint32_t regno, uint32_t value);
+    void watch_pc();
+
+    // Memory
+    uint32_t remap(uint32_t addr) const;
+    bool read_memory(uint32_t addr, uint32_t len, std::vector<uint8_t>& data);
+    bool write_memory(uint32_t addr, const uint8_t* data, uint32_t len);
+    bool sba_read(const std::vector<uint32_t>& addrs, std::vector<uint32_t>& words);
+    bool sba_write_bytes(uint32_t addr, const uint8_t* data, uint32_t len);
+    bool insert_breakpoint(uint32_t addr, uint32_t kind);
+    bool remove_breakpoint(uint32_t addr);
+
+    Vpulpissimo* top_;
+    ClockScheduler& sched_;
+    JtagDtm dtm_;
+    L2Backdoor l2_;
+    uint32_t rom_base_;
+    uint32_t rom_size_;
+    uint32_t l2_base_;
+
+    int listen_fd_;
+    int client_fd_;
+    int port_;
+    std::string rx_;
+    bool no_ack_;
+    bool detached_;
+    bool kill_;
+
+    bool stopped_;                    // Core halted, GDB in control
+    int signal_;                      // Reported by the last stop reply
+    bool running_;                    // Resumed, waiting for debug mode
+    bool resuming_;                   // ... still leaving the debug ROM
+    bool entered_debug_;
+    uint64_t next_poll_;
+
+    std::deque<Request> dmi_out_;
+    std::vector<std::pair<uint8_t, uint32_t>> dmi_in_;
+    bool dmi_broken_;
+
+    std::map<uint32_t, Breakpoint> breakpoints_;
+    uint64_t packets_;
+};
+
+#endif // GDB_SERVER_H
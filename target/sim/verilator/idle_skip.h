@@ -0,0 +1,149 @@
+// Copyright 2025 Custom IP Integration
+// Idle fast-forward for the Verilator harness.
+//
+// While the FC core sleeps in wfi (core_sleep_o), no uDMA channel is enabled
+// and the advanced timer is clock gated, nothing in the SoC changes state
+// except free-running counters. The
+// skipper then jumps the clocks straight to a few cycles before the next event
+// that could wake the core:
+//   - a compare match of the FC timer (its counters are advanced by hand),
+//   - the next slow (32 kHz reference) clock edge when it is a separate clock,
+//   - a harness limit (max_cycles, scheduled stimulus).
+// The RTL evaluates the last cycles before the event itself, so interrupts
+// and wake-up are produced by the design, not by the harness.
+
+#ifndef IDLE_SKIP_H
+#define IDLE_SKIP_H
+
+#include "Vpulpissimo.h"
+#include "Vpulpissimo_XBAR_TCDM_BUS.h"
+#include "clock_scheduler.h"
+#include "tb_hier.h"
+#include <cstdint>
+
+// apb_timer_unit configuration register bits
+#define TIMER_CFG_ENABLE   (1u << 0)
+#define TIMER_CFG_IRQ_EN   (1u << 2)
+#define TIMER_CFG_CMP_CLR  (1u << 4)
+#define TIMER_CFG_ONE_SHOT (1u << 5)
+#define TIMER_CFG_PRESC_EN (1u << 6)
+#define TIMER_CFG_REF_CLK  (1u << 7)
+#define TIMER_CFG_MODE_64  (1u << 31)
+
+class IdleSkipper {
+public:
+    // Skips shorter than this are not worth the bookkeeping
+    static const uint64_t MIN_SKIP = 32;
+    // Cycles left for the RTL to evaluate before the next event
+    static const uint64_t MARGIN = 4;
+
+    // `slow_clock` is the scheduler id of a separate slow/reference clock, or
+    // -1 when the main clock is the reference clock
+    IdleSkipper(Vpulpissimo* top, int slow_clock)
+        : top_(top), slow_clock_(slow_clock), asleep_cycles_(0), skips_(0), skipped_(0) {
+        udma_rx_ = TB_UDMA_RX_BUS(top);
+        udma_tx_ = TB_UDMA_TX_BUS(top);
+    }
+
+    // Call once per main clock cycle, after the rising edge was evaluated.
+    // Returns the number of cycles skipped (0 if the SoC is busy).
+    uint64_t step(ClockScheduler& sched, uint64_t limit_cycle) {
+        if (!idle()) {
+            asleep_cycles_ = 0;
+            return 0;
+        }
+        // A pending interrupt wakes the core on the cycle after it arrives, so
+        // only trust a sleep state that has held for a full cycle
+        if (++asleep_cycles_ < 2) return 0;
+
+        uint64_t n = limit_cycle > sched.get_cycle() ? limit_cycle - sched.get_cycle() : 0;
+        uint64_t period = sched.period_ps(sched.main_clock());
+        if (slow_clock_ >= 0) {
+            uint64_t to_edge = (sched.next_rise_ps(slow_clock_) - sched.time_ps()) / period;
+            if (to_edge < n) n = to_edge;
+        }
+        uint64_t timer = timer_cycles_to_event();
+        if (timer < n) n = timer;
+        if (n < MIN_SKIP + MARGIN) return 0;
+        n -= MARGIN;
+
+        advance_timer(n);
+        sched.skip(n * period);
+        top_->eval();
+        skips_++;
+        skipped_ += n;
+        asleep_cycles_ = 0;
+        return n;
+    }
+
+    uint64_t skips() const { return skips_; }
+    uint64_t skipped_cycles() const { return skipped_; }
+
+private:
+    // A uDMA channel between bus beats (e.g. waiting for the next UART byte)
+    // and a running PWM/advanced timer both raise events the skip would miss
+    bool idle() const {
+        return TB_FC_CORE_SIG(top_, core_sleep_o) && !udma_rx_->req && !udma_tx_->req &&
+               !TB_UDMA_SIG(top_, s_rx_cfg_en) && !TB_UDMA_SIG(top_, s_tx_cfg_en) &&
+               !TB_ADV_TIMER_SIG(top_, u_apb_if__DOT__r_clk_en);
+    }
+
+    // Main clock cycles until counter `count` reaches `cmp`, or UINT64_MAX if
+    // the counter cannot be fast-forwarded or raise an event
+    uint64_t counter_distance(uint32_t cfg, uint32_t count, uint32_t cmp) const {
+        if (!(cfg & TIMER_CFG_ENABLE)) return UINT64_MAX;
+        if (!(cfg & (TIMER_CFG_IRQ_EN | TIMER_CFG_CMP_CLR | TIMER_CFG_ONE_SHOT))) return UINT64_MAX;
+        // Only changes on slow clock edges, which already bound the skip
+        if (!counts_main_clock(cfg)) return UINT64_MAX;
+        uint32_t d = cmp - count;
+        return d == 0 ? UINT64_MAX : d;
+    }
+
+    // A counter on the reference clock follows the main clock unless the slow
+    // clock is driven separately
+    bool counts_main_clock(uint32_t cfg) const {
+        return !(cfg & TIMER_CFG_REF_CLK) || slow_clock_ < 0;
+    }
+
+    // Prescaled and 64-bit cascaded timers are not modelled; they disable skipping
+    bool timer_modelled() const {
+        uint32_t cfg_lo = TB_TIMER_SIG(top_, s_cfg_lo_reg);
+        uint32_t cfg_hi = TB_TIMER_SIG(top_, s_cfg_hi_reg);
+        if ((cfg_lo & TIMER_CFG_ENABLE) && (cfg_lo & (TIMER_CFG_PRESC_EN | TIMER_CFG_MODE_64))) return false;
+        if ((cfg_hi & TIMER_CFG_ENABLE) && (cfg_hi & TIMER_CFG_PRESC_EN)) return false;
+        return true;
+    }
+
+    uint64_t timer_cycles_to_event() const {
+        if (!timer_modelled()) return 0;
+        uint64_t lo = counter_distance(TB_TIMER_SIG(top_, s_cfg_lo_reg),
+                                       TB_TIMER_SIG(top_, counter_lo_i__DOT__s_count_reg),
+                                       TB_TIMER_SIG(top_, s_timer_cmp_lo_reg));
+        uint64_t hi = counter_distance(TB_TIMER_SIG(top_, s_cfg_hi_reg),
+                                       TB_TIMER_SIG(top_, counter_hi_i__DOT__s_count_reg),
+                                       TB_TIMER_SIG(top_, s_timer_cmp_hi_reg));
+        return lo < hi ? lo : hi;
+    }
+
+    // Account the skipped cycles in the counters clocked by the main clock
+    void advance_timer(uint64_t n) {
+        uint32_t cfg_lo = TB_TIMER_SIG(top_, s_cfg_lo_reg);
+        uint32_t cfg_hi = TB_TIMER_SIG(top_, s_cfg_hi_reg);
+        if ((cfg_lo & TIMER_CFG_ENABLE) && counts_main_clock(cfg_lo)) {
+            TB_TIMER_SIG(top_, counter_lo_i__DOT__s_count_reg) += (uint32_t)n;
+        }
+        if ((cfg_hi & TIMER_CFG_ENABLE) && counts_main_clock(cfg_hi)) {
+            TB_TIMER_SIG(top_, counter_hi_i__DOT__s_count_reg) += (uint32_t)n;
+        }
+    }
+
+    Vpulpissimo* top_;
+    Vpulpissimo_XBAR_TCDM_BUS* udma_rx_;
+    Vpulpissimo_XBAR_TCDM_BUS* udma_tx_;
+    int slow_clock_;
+    uint64_t asleep_cycles_;
+    uint64_t skips_;
+    uint64_t skipped_;
+};
+
+#endif // IDLE_SKIP_H
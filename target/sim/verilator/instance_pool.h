@@ -0,0 +1,162 @@
+// Copyright 2025 Custom IP Integration
+// Several independent SoC simulations in one process.
+//
+// +instances=<file> lists one instance per line: a name followed by that
+// instance's plusargs ('#' starts a comment). Each instance runs the normal
+// harness with the command line's other plusargs followed by its own, with %n
+// replaced by the instance name (+report=%n.json). It gets its own
+// VerilatedContext and model, memory image and report. +jobs=<n> threads
+// (default: one per CPU) take instances off the list until it is empty.
+//
+// ELF files are parsed once per process and shared read-only. Console output
+// of an instance goes to <name>.log through its thread's own console streams
+// (tb_console.h). UART output to stdout and the debugger servers are per
+// process resources: give each instance its own +uart_out= or port.
+
+#ifndef INSTANCE_POOL_H
+#define INSTANCE_POOL_H
+
+#include "elf_loader.h"
+#include "tb_console.h"
+#include "tb_format.h"
+#include "verilated.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct InstanceSpec {
+    std::string name;
+    std::vector<std::string> args;
+};
+
+// Returns false and prints the reason on errors
+inline bool read_instance_list(const std::string& path, std::vector<InstanceSpec>& specs) {
+    std::ifstream is(path);
+    if (!is) {
+        tb_err() << "Error: Cannot open instance list " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(is, line)) {
+        std::stringstream ss(line.substr(0, line.find('#')));
+        InstanceSpec spec;
+        if (!(ss >> spec.name)) continue;
+        for (std::string arg; ss >> arg;) spec.args.push_back(arg);
+        for (const InstanceSpec& s : specs) {
+            if (s.name == spec.name) {
+                tb_err() << "Error: Instance " << spec.name << " listed twice in " << path << std::endl;
+                return false;
+            }
+        }
+        specs.push_back(spec);
+    }
+    return true;
+}
+
+// Parsed ELF images shared by all instances. An image is opened on first use
+// and stays mapped until the process ends.
+class ElfCache {
+public:
+    // nullptr if the file cannot be loaded
+    const ElfImage* get(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = images_.find(path);
+        if (it == images_.end()) {
+            std::unique_ptr<ElfImage> elf(new ElfImage);
+            if (!elf->open(path)) elf.reset();
+            it = images_.emplace(path, std::move(elf)).first;
+        }
+        return it->second.get();
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<ElfImage>> images_;
+};
+
+// Harness entry point for one instance
+typedef std::function<int(VerilatedContext* context, int argc, char** argv)> InstanceMain;
+
+// Run every instance on a pool of `jobs` threads. Returns 0 when all ran and
+// exited with status 0; an instance whose log cannot be created is not run.
+inline int run_instances(const std::vector<InstanceSpec>& specs, const std::string& argv0,
+                         const std::vector<std::string>& common, unsigned jobs, const InstanceMain& run) {
+    if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    if (jobs > specs.size()) jobs = (unsigned)specs.size();
+    tb_out() << "Running " << specs.size() << " instances on " << jobs << " threads" << std::endl;
+
+    std::vector<int> status(specs.size(), 1);
+    std::vector<char> ran(specs.size(), 0);
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> done(0);
+    std::mutex report_mutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < specs.size(); i = next++) {
+            const InstanceSpec& spec = specs[i];
+            std::vector<std::string> args(1, argv0);
+            args.insert(args.end(), common.begin(), common.end());
+            args.insert(args.end(), spec.args.begin(), spec.args.end());
+            std::vector<char*> argv;
+            for (std::string& a : args) {
+                for (size_t pos; (pos = a.find("%n")) != std::string::npos;) a.replace(pos, 2, spec.name);
+                argv.push_back(&a[0]);
+            }
+            argv.push_back(nullptr);
+
+            auto start = std::chrono::steady_clock::now();
+            std::ofstream log(spec.name + ".log");
+            if (log) {
+                ran[i] = 1;
+                tb_console_redirect(log.rdbuf());
+                try {
+                    std::unique_ptr<VerilatedContext> context(new VerilatedContext);
+                    status[i] = run(context.get(), (int)args.size(), argv.data());
+                } catch (const std::exception& e) {
+                    tb_err() << "Error: " << e.what() << std::endl;
+                }
+                tb_console_redirect(nullptr);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(report_mutex);
+            if (!ran[i]) {
+                tb_err() << "  [" << ++done << "/" << specs.size() << "] " << spec.name
+                         << ": not run, cannot create " << spec.name << ".log" << std::endl;
+                continue;
+            }
+            tb_out() << "  [" << ++done << "/" << specs.size() << "] " << spec.name << ": exit status "
+                     << status[i] << ", " << tb_fixed(seconds, 1) << " s (" << spec.name << ".log)" << std::endl;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < jobs; t++) threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads) t.join();
+
+    size_t failed = 0;
+    size_t not_run = 0;
+    for (size_t i = 0; i < specs.size(); i++) {
+        if (!ran[i]) {
+            not_run++;
+        } else if (status[i] != 0) {
+            failed++;
+        }
+    }
+    tb_out() << specs.size() - failed - not_run << "/" << specs.size() << " instances exited with status 0";
+    if (not_run) tb_out() << ", " << not_run << " not run";
+    tb_out() << std::endl;
+    return failed || not_run ? 1 : 0;
+}
+
+#endif // INSTANCE_POOL_H
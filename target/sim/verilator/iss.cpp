@@ -0,0 +1,473 @@
+// Copyright 2025 Custom IP Integration
+// Functional RV32IMC + Zicsr instruction-set simulator for fast-forward.
+
+#include "iss.h"
+#include "tb_console.h"
+#include <cstring>
+#include <iostream>
+
+// Instruction encoders, used to expand RVC and to build the trampoline
+static uint32_t enc_r(uint32_t op, uint32_t rd, uint32_t f3, uint32_t rs1, uint32_t rs2, uint32_t f7) {
+    return op | rd << 7 | f3 << 12 | rs1 << 15 | rs2 << 20 | f7 << 25;
+}
+static uint32_t enc_i(uint32_t op, uint32_t rd, uint32_t f3, uint32_t rs1, int32_t imm) {
+    return op | rd << 7 | f3 << 12 | rs1 << 15 | ((uint32_t)imm & 0xFFF) << 20;
+}
+static uint32_t enc_s(uint32_t op, uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t imm) {
+    uint32_t u = (uint32_t)imm;
+    return op | (u & 0x1F) << 7 | f3 << 12 | rs1 << 15 | rs2 << 20 | ((u >> 5) & 0x7F) << 25;
+}
+static uint32_t enc_b(uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t imm) {
+    uint32_t u = (uint32_t)imm;
+    return 0x63 | ((u >> 11) & 1) << 7 | ((u >> 1) & 0xF) << 8 | f3 << 12 | rs1 << 15 | rs2 << 20 |
+           ((u >> 5) & 0x3F) << 25 | ((u >> 12) & 1) << 31;
+}
+static uint32_t enc_u(uint32_t op, uint32_t rd, uint32_t imm) {
+    return op | rd << 7 | (imm & 0xFFFFF000u);
+}
+static uint32_t enc_j(uint32_t rd, int32_t imm) {
+    uint32_t u = (uint32_t)imm;
+    return 0x6F | rd << 7 | ((u >> 12) & 0xFF) << 12 | ((u >> 11) & 1) << 20 |
+           ((u >> 1) & 0x3FF) << 21 | ((u >> 20) & 1) << 31;
+}
+
+static int32_t sext(uint32_t v, int bits) {
+    return (int32_t)(v << (32 - bits)) >> (32 - bits);
+}
+
+static const uint32_t MSTATUS_MIE = 1u << 3;
+static const uint32_t MSTATUS_MPIE = 1u << 7;
+static const uint32_t MSTATUS_MPP = 3u << 11;
+static const uint32_t MISA_RV32IMC = (1u << 30) | (1u << 2) | (1u << 8) | (1u << 12);
+static const uint32_t INSTR_MRET = 0x30200073;
+static const uint32_t INSTR_WFI = 0x10500073;
+static const uint32_t INSTR_FENCE_I = 0x0000100F;
+
+Iss::Iss(uint32_t base, uint32_t size, uint32_t alias_base)
+    : mem_(size, 0), base_(base), alias_base_(alias_base), ignore_mmio_(false), pc_(0),
+      mstatus_(MSTATUS_MPP), mie_(0), mtvec_(0), mscratch_(0), mepc_(0), mcause_(0),
+      instret_(0), reason_(STOP_NONE) {
+    memset(x_, 0, sizeof(x_));
+}
+
+const char* Iss::reason_name(StopReason r) {
+    switch (r) {
+    case STOP_PC: return "marker PC reached";
+    case STOP_INSTRS: return "instruction count reached";
+    case STOP_MMIO: return "peripheral access";
+    case STOP_CSR: return "unmodelled CSR";
+    case STOP_UNSUPPORTED: return "unsupported instruction";
+    case STOP_WFI: return "wfi";
+    case STOP_FETCH: return "fetch outside L2";
+    default: return "none";
+    }
+}
+
+uint8_t* Iss::translate(uint32_t addr, uint32_t len) {
+    uint32_t size = (uint32_t)mem_.size();
+    if (addr - base_ < size && addr - base_ + len <= size) return &mem_[addr - base_];
+    if (addr - alias_base_ < size && addr - alias_base_ + len <= size) return &mem_[addr - alias_base_];
+    return nullptr;
+}
+
+bool Iss::fetch(uint32_t& instr, uint32_t& len) {
+    uint8_t* p = translate(pc_, 2);
+    if (!p) return false;
+    uint16_t lo;
+    memcpy(&lo, p, 2);
+    if ((lo & 0x3) != 0x3) {
+        instr = expand(lo);
+        len = 2;
+        return true;
+    }
+    p = translate(pc_, 4);
+    if (!p) return false;
+    memcpy(&instr, p, 4);
+    len = 4;
+    return true;
+}
+
+bool Iss::csr_read(uint32_t csr, uint32_t& value) const {
+    switch (csr) {
+    case CSR_MSTATUS: value = mstatus_; return true;
+    case CSR_MISA: value = MISA_RV32IMC; return true;
+    case CSR_MIE: value = mie_; return true;
+    case CSR_MTVEC: value = mtvec_; return true;
+    case CSR_MSCRATCH: value = mscratch_; return true;
+    case CSR_MEPC: value = mepc_; return true;
+    case CSR_MCAUSE: value = mcause_; return true;
+    default: return false; // Counters, hart id, debug and custom CSRs belong to the RTL
+    }
+}
+
+bool Iss::csr_write(uint32_t csr, uint32_t value) {
+    switch (csr) {
+    case CSR_MSTATUS: mstatus_ = (value & (MSTATUS_MIE | MSTATUS_MPIE)) | MSTATUS_MPP; return true;
+    case CSR_MISA: return true;
+    case CSR_MIE: mie_ = value; return true;
+    case CSR_MTVEC: mtvec_ = value; return true;
+    case CSR_MSCRATCH: mscratch_ = value; return true;
+    case CSR_MEPC: mepc_ = value & ~1u; return true;
+    case CSR_MCAUSE: mcause_ = value; return true;
+    default: return false;
+    }
+}
+
+Iss::StopReason Iss::run(uint32_t stop_pc, uint64_t max_instrs) {
+    reason_ = STOP_NONE;
+    while (reason_ == STOP_NONE) {
+        if (pc_ == stop_pc) {
+            reason_ = STOP_PC;
+        } else if (instret_ >= max_instrs) {
+            reason_ = STOP_INSTRS;
+        } else if (step()) {
+            instret_++;
+        }
+    }
+    return reason_;
+}
+
+// Execute one instruction. Nothing is modified when it returns false.
+bool Iss::step() {
+    uint32_t in, len;
+    if (!fetch(in, len)) {
+        reason_ = STOP_FETCH;
+        return false;
+    }
+    if (in == 0) {
+        reason_ = STOP_UNSUPPORTED;
+        return false;
+    }
+    uint32_t rd = (in >> 7) & 0x1F;
+    uint32_t f3 = (in >> 12) & 0x7;
+    uint32_t f7 = in >> 25;
+    uint32_t a = x_[(in >> 15) & 0x1F];
+    uint32_t b = x_[(in >> 20) & 0x1F];
+    int32_t imm_i = (int32_t)in >> 20;
+    uint32_t next = pc_ + len;
+    uint32_t result = 0;
+    bool write = true;
+
+    switch (in & 0x7F) {
+    case 0x37: // lui
+        result = in & 0xFFFFF000u;
+        break;
+    case 0x17: // auipc
+        result = pc_ + (in & 0xFFFFF000u);
+        break;
+    case 0x6F: { // jal
+        int32_t off = sext(((in >> 31) & 1) << 20 | ((in >> 12) & 0xFF) << 12 |
+                           ((in >> 20) & 1) << 11 | ((in >> 21) & 0x3FF) << 1, 21);
+        result = next;
+        next = pc_ + off;
+        break;
+    }
+    case 0x67: // jalr
+        if (f3 != 0) goto unsupported;
+        result = next;
+        next = (a + imm_i) & ~1u;
+        break;
+    case 0x63: { // branches
+        bool taken;
+        switch (f3) {
+        case 0: taken = a == b; break;
+        case 1: taken = a != b; break;
+        case 4: taken = (int32_t)a < (int32_t)b; break;
+        case 5: taken = (int32_t)a >= (int32_t)b; break;
+        case 6: taken = a < b; break;
+        case 7: taken = a >= b; break;
+        default: goto unsupported;
+        }
+        if (taken) {
+            next = pc_ + sext(((in >> 31) & 1) << 12 | ((in >> 7) & 1) << 11 |
+                              ((in >> 25) & 0x3F) << 5 | ((in >> 8) & 0xF) << 1, 13);
+        }
+        write = false;
+        break;
+    }
+    case 0x03: { // loads
+        static const uint32_t sizes[8] = {1, 2, 4, 0, 1, 2, 0, 0};
+        uint32_t size = sizes[f3];
+        if (!size) goto unsupported;
+        uint8_t* p = translate(a + imm_i, size);
+        if (!p) {
+            if (!ignore_mmio_) {
+                reason_ = STOP_MMIO;
+                return false;
+            }
+            result = 0;
+            break;
+        }
+        uint32_t v = 0;
+        memcpy(&v, p, size);
+        if (f3 == 0) v = (uint32_t)(int8_t)v;
+        if (f3 == 1) v = (uint32_t)(int16_t)v;
+        result = v;
+        break;
+    }
+    case 0x23: { // stores
+        if (f3 > 2) goto unsupported;
+        uint32_t size = 1u << f3;
+        int32_t off = sext((in >> 25) << 5 | ((in >> 7) & 0x1F), 12);
+        uint8_t* p = translate(a + off, size);
+        if (p) {
+            memcpy(p, &b, size);
+        } else if (!ignore_mmio_) {
+            reason_ = STOP_MMIO;
+            return false;
+        }
+        write = false;
+        break;
+    }
+    case 0x13: { // register-immediate
+        uint32_t shamt = (in >> 20) & 0x1F;
+        switch (f3) {
+        case 0: result = a + imm_i; break;
+        case 2: result = (int32_t)a < imm_i; break;
+        case 3: result = a < (uint32_t)imm_i; break;
+        case 4: result = a ^ imm_i; break;
+        case 6: result = a | imm_i; break;
+        case 7: result = a & imm_i; break;
+        case 1:
+            if (f7 != 0) goto unsupported;
+            result = a << shamt;
+            break;
+        case 5:
+            if (f7 == 0) {
+                result = a >> shamt;
+            } else if (f7 == 0x20) {
+                result = (uint32_t)((int32_t)a >> shamt);
+            } else {
+                goto unsupported;
+            }
+            break;
+        }
+        break;
+    }
+    case 0x33: // register-register
+        if (f7 == 0x01) {
+            int64_t sa = (int32_t)a, sb = (int32_t)b;
+            switch (f3) {
+            case 0: result = a * b; break;
+            case 1: result = (uint32_t)((sa * sb) >> 32); break;
+            case 2: result = (uint32_t)((sa * (int64_t)(uint64_t)b) >> 32); break;
+            case 3: result = (uint32_t)(((uint64_t)a * b) >> 32); break;
+            case 4:
+                if (b == 0) result = 0xFFFFFFFFu;
+                else if (a == 0x80000000u && b == 0xFFFFFFFFu) result = a;
+                else result = (uint32_t)((int32_t)a / (int32_t)b);
+                break;
+            case 5: result = b ? a / b : 0xFFFFFFFFu; break;
+            case 6:
+                if (b == 0) result = a;
+                else if (a == 0x80000000u && b == 0xFFFFFFFFu) result = 0;
+                else result = (uint32_t)((int32_t)a % (int32_t)b);
+                break;
+            case 7: result = b ? a % b : a; break;
+            }
+        } else if (f7 == 0 || (f7 == 0x20 && (f3 == 0 || f3 == 5))) {
+            switch (f3) {
+            case 0: result = f7 ? a - b : a + b; break;
+            case 1: result = a << (b & 0x1F); break;
+            case 2: result = (int32_t)a < (int32_t)b; break;
+            case 3: result = a < b; break;
+            case 4: result = a ^ b; break;
+            case 5: result = f7 ? (uint32_t)((int32_t)a >> (b & 0x1F)) : a >> (b & 0x1F); break;
+            case 6: result = a | b; break;
+            case 7: result = a & b; break;
+            }
+        } else {
+            goto unsupported;
+        }
+        break;
+    case 0x0F: // fence, fence.i
+        write = false;
+        break;
+    case 0x73: { // system
+        if (f3 == 0) {
+            if (in == INSTR_MRET) {
+                next = mepc_;
+                mstatus_ = (mstatus_ & MSTATUS_MPIE ? MSTATUS_MIE : 0) | MSTATUS_MPIE | MSTATUS_MPP;
+                write = false;
+                break;
+            }
+            if (in == INSTR_WFI) {
+                reason_ = STOP_WFI;
+                return false;
+            }
+            goto unsupported; // ecall, ebreak, dret
+        }
+        if (f3 == 4) goto unsupported;
+        uint32_t csr = in >> 20;
+        uint32_t src = (f3 & 4) ? (in >> 15) & 0x1F : a;
+        uint32_t old;
+        if (!csr_read(csr, old)) {
+            reason_ = STOP_CSR;
+            return false;
+        }
+        uint32_t value = old;
+        switch (f3 & 3) {
+        case 1: value = src; break;
+        case 2: value = old | src; break;
+        case 3: value = old & ~src; break;
+        }
+        // csrrs/csrrc with x0 only read
+        bool writes = (f3 & 3) == 1 || ((in >> 15) & 0x1F) != 0;
+        if (writes && !csr_write(csr, value)) {
+            reason_ = STOP_CSR;
+            return false;
+        }
+        result = old;
+        break;
+    }
+    default:
+        goto unsupported;
+    }
+
+    if (write && rd != 0) x_[rd] = result;
+    pc_ = next;
+    return true;
+
+unsupported:
+    reason_ = STOP_UNSUPPORTED;
+    return false;
+}
+
+// Expand a compressed instruction into its RV32I equivalent
+uint32_t Iss::expand(uint16_t c) {
+    uint32_t rd = (c >> 7) & 0x1F;
+    uint32_t rs2 = (c >> 2) & 0x1F;
+    uint32_t rdp = ((c >> 7) & 0x7) + 8;  // rd' / rs1'
+    uint32_t rs2p = ((c >> 2) & 0x7) + 8; // rs2' / rd'
+    int32_t imm6 = sext(((c >> 7) & 0x20) | ((c >> 2) & 0x1F), 6);
+    int32_t imm_j = sext(((c >> 1) & 0x800) | ((c >> 7) & 0x10) | ((c >> 1) & 0x300) |
+                         ((c << 2) & 0x400) | ((c >> 1) & 0x40) | ((c << 1) & 0x80) |
+                         ((c >> 2) & 0xE) | ((c << 3) & 0x20), 12);
+    int32_t imm_b = sext(((c >> 4) & 0x100) | ((c >> 7) & 0x18) | ((c << 1) & 0xC0) |
+                         ((c >> 2) & 0x6) | ((c << 3) & 0x20), 9);
+    uint32_t imm_lw = ((c >> 7) & 0x38) | ((c << 1) & 0x40) | ((c >> 4) & 0x4);
+
+    switch ((c >> 13) << 2 | (c & 0x3)) {
+    case 0x00: { // c.addi4spn
+        uint32_t imm = ((c >> 7) & 0x30) | ((c >> 1) & 0x3C0) | ((c >> 4) & 0x4) | ((c >> 2) & 0x8);
+        return imm ? enc_i(0x13, rs2p, 0, 2, imm) : 0;
+    }
+    case 0x08: return enc_i(0x03, rs2p, 2, rdp, imm_lw);    // c.lw
+    case 0x18: return enc_s(0x23, 2, rdp, rs2p, imm_lw);    // c.sw
+    case 0x01: return enc_i(0x13, rd, 0, rd, imm6);         // c.addi
+    case 0x05: return enc_j(1, imm_j);                      // c.jal
+    case 0x09: return enc_i(0x13, rd, 0, 0, imm6);          // c.li
+    case 0x0D:
+        if (rd == 2) { // c.addi16sp
+            int32_t imm = sext(((c >> 3) & 0x200) | ((c >> 2) & 0x10) | ((c << 1) & 0x40) |
+                               ((c << 4) & 0x180) | ((c << 3) & 0x20), 10);
+            return imm ? enc_i(0x13, 2, 0, 2, imm) : 0;
+        }
+        return imm6 ? enc_u(0x37, rd, (uint32_t)imm6 << 12) : 0; // c.lui
+    case 0x11: {
+        uint32_t shamt = ((c >> 7) & 0x20) | rs2;
+        switch ((c >> 10) & 0x3) {
+        case 0: return shamt < 32 ? enc_i(0x13, rdp, 5, rdp, shamt) : 0;           // c.srli
+        case 1: return shamt < 32 ? enc_i(0x13, rdp, 5, rdp, shamt | 0x400) : 0;  // c.srai
+        case 2: return enc_i(0x13, rdp, 7, rdp, imm6);                             // c.andi
+        default:
+            if (c & 0x1000) return 0;
+            switch ((c >> 5) & 0x3) {
+            case 0: return enc_r(0x33, rdp, 0, rdp, rs2p, 0x20); // c.sub
+            case 1: return enc_r(0x33, rdp, 4, rdp, rs2p, 0);    // c.xor
+            case 2: return enc_r(0x33, rdp, 6, rdp, rs2p, 0);    // c.or
+            default: return enc_r(0x33, rdp, 7, rdp, rs2p, 0);   // c.and
+            }
+        }
+    }
+    case 0x15: return enc_j(0, imm_j);                      // c.j
+    case 0x19: return enc_b(0, rdp, 0, imm_b);              // c.beqz
+    case 0x1D: return enc_b(1, rdp, 0, imm_b);              // c.bnez
+    case 0x02: {                                            // c.slli
+        uint32_t shamt = ((c >> 7) & 0x20) | rs2;
+        return shamt < 32 ? enc_i(0x13, rd, 1, rd, shamt) : 0;
+    }
+    case 0x0A: {                                            // c.lwsp
+        uint32_t imm = ((c >> 7) & 0x20) | ((c >> 2) & 0x1C) | ((c << 4) & 0xC0);
+        return rd ? enc_i(0x03, rd, 2, 2, imm) : 0;
+    }
+    case 0x12:
+        if (!(c & 0x1000)) {
+            if (rs2 == 0) return rd ? enc_i(0x67, 0, 0, rd, 0) : 0; // c.jr
+            return enc_r(0x33, rd, 0, 0, rs2, 0);                     // c.mv
+        }
+        if (rs2 == 0) return rd ? enc_i(0x67, 1, 0, rd, 0) : 0;     // c.jalr (c.ebreak: 0)
+        return enc_r(0x33, rd, 0, rd, rs2, 0);                        // c.add
+    case 0x1A: {                                            // c.swsp
+        uint32_t imm = ((c >> 7) & 0x3C) | ((c >> 1) & 0xC0);
+        return enc_s(0x23, 2, 2, rs2, imm);
+    }
+    default:
+        return 0; // Floating point and reserved encodings
+    }
+}
+
+// Put the entry word back, restore the CSRs with x1/x2 as scratch, then every
+// GPR, then jump to the PC. Interrupts stay off until the last instruction
+// before the jump; one taken there returns to the jump, so mepc and the other
+// CSRs keep the values the ISS left.
+std::vector<uint32_t> Iss::trampoline(uint32_t at, uint32_t entry, uint32_t entry_word, uint32_t pc) const {
+    std::vector<uint32_t> code;
+    auto li = [&code](uint32_t rd, uint32_t value) {
+        code.push_back(enc_u(0x37, rd, value + 0x800));
+        code.push_back(enc_i(0x13, rd, 0, rd, sext(value & 0xFFF, 12)));
+    };
+    auto csrw = [&](uint32_t csr, uint32_t value) {
+        li(1, value);
+        code.push_back(enc_i(0x73, 0, 1, 1, (int32_t)csr));
+    };
+    li(1, entry);
+    li(2, entry_word);
+    code.push_back(enc_s(0x23, 2, 1, 2, 0));                  // sw x2, 0(x1)
+    code.push_back(INSTR_FENCE_I);
+    csrw(CSR_MSTATUS, mstatus_ & ~MSTATUS_MIE);
+    csrw(CSR_MTVEC, mtvec_);
+    csrw(CSR_MSCRATCH, mscratch_);
+    csrw(CSR_MCAUSE, mcause_);
+    csrw(CSR_MIE, mie_);
+    csrw(CSR_MEPC, mepc_);
+    for (uint32_t r = 1; r < 32; r++) li(r, x_[r]);
+    if (mstatus_ & MSTATUS_MIE) code.push_back(enc_i(0x73, 0, 6, MSTATUS_MIE, CSR_MSTATUS)); // csrsi
+    uint32_t jump_at = at + (uint32_t)code.size() * 4;
+    code.push_back(enc_j(0, (int32_t)(pc - jump_at)));
+    return code;
+}
+
+// L2 address of `addr`, which may be in the ROM alias window
+uint32_t Iss::to_l2(uint32_t addr) const {
+    return addr - alias_base_ < mem_.size() ? addr - alias_base_ + base_ : addr;
+}
+
+static bool jal_reaches(uint32_t from, uint32_t to) {
+    int32_t offset = (int32_t)(to - from);
+    return offset >= -(1 << 20) && offset < (1 << 20);
+}
+
+bool Iss::handoff(L2Backdoor& l2, uint32_t entry) const {
+    if (pc_ == entry && instret_ == 0) return true; // Nothing ran
+    uint32_t entry_l2 = to_l2(entry);
+    uint32_t pc_l2 = to_l2(pc_);
+    uint32_t bytes = (uint32_t)trampoline(0, 0, 0, 0).size() * 4;
+    // The stack below sp is free by the ABI; leave a small gap for safety
+    uint32_t at = (x_[2] - bytes - 64) & ~0xFu;
+    if (!L2Backdoor::contains(at) || !L2Backdoor::contains(at + bytes - 1) ||
+        !L2Backdoor::contains(entry_l2) || !jal_reaches(entry_l2, at) || !jal_reaches(at + bytes - 4, pc_l2)) {
+        tb_err() << "Error: ISS handoff needs sp, the entry point and the PC in L2 (sp 0x" << std::hex
+                  << x_[2] << ", entry 0x" << entry << ", pc 0x" << pc_ << ")" << std::dec << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> image(mem_);
+    uint32_t entry_word;
+    memcpy(&entry_word, &image[entry_l2 - base_], 4);
+    std::vector<uint32_t> code = trampoline(at, entry_l2, entry_word, pc_l2);
+    memcpy(&image[at - base_], code.data(), bytes);
+    uint32_t stub = enc_j(0, (int32_t)(at - entry_l2));
+    memcpy(&image[entry_l2 - base_], &stub, 4);
+    return l2.write_block(base_, image.data(), image.size()) == image.size();
+}
@@ -0,0 +1,82 @@
+// Copyright 2025 Custom IP Integration
+// Functional RV32IMC + Zicsr instruction-set simulator for fast-forward.
+//
+// The ISS runs the program on a private copy of L2 (ROM addresses alias L2,
+// as in the harness loader) from the entry point up to a marker PC or an
+// instruction count, then hands the architectural state over to the RTL:
+//   - the L2 image is written back through the backdoor
+//   - a trampoline placed just below the stack pointer puts the original
+//     entry instruction back, restores the CSRs and all GPRs and jumps to the
+//     PC where the ISS stopped
+//   - the first instruction at the entry point becomes a jump to it
+// so the RTL, on reaching the entry point, continues where the ISS stopped,
+// and only the stack below sp differs from the image the ISS left.
+//
+// Anything the ISS cannot model exactly (peripheral accesses, counters, traps,
+// wfi, unknown or Xpulp instructions) stops it before that instruction and
+// the RTL takes over from there.
+
+#ifndef ISS_H
+#define ISS_H
+
+#include "l2_backdoor.h"
+#include <cstdint>
+#include <vector>
+
+class Iss {
+public:
+    enum StopReason {
+        STOP_NONE, STOP_PC, STOP_INSTRS, STOP_MMIO, STOP_CSR, STOP_UNSUPPORTED, STOP_WFI, STOP_FETCH
+    };
+
+    // Memory seen by the ISS: [base, base + size), plus an alias window
+    // [alias_base, alias_base + size) that maps onto the same bytes
+    Iss(uint32_t base, uint32_t size, uint32_t alias_base);
+
+    std::vector<uint8_t>& memory() { return mem_; }
+
+    // Peripheral accesses: stop (default) or drop stores and read zero
+    void set_ignore_mmio(bool ignore) { ignore_mmio_ = ignore; }
+
+    void set_pc(uint32_t pc) { pc_ = pc; }
+    uint32_t pc() const { return pc_; }
+    uint32_t reg(int i) const { return x_[i]; }
+    uint64_t instret() const { return instret_; }
+
+    // Run until the PC equals `stop_pc` or `max_instrs` instructions retired
+    StopReason run(uint32_t stop_pc, uint64_t max_instrs);
+
+    static const char* reason_name(StopReason r);
+
+    // Copy memory and state into the RTL. `entry` is where the RTL starts
+    // executing the program. Returns false if the state cannot be handed over.
+    bool handoff(L2Backdoor& l2, uint32_t entry) const;
+
+private:
+    enum Csr {
+        CSR_MSTATUS = 0x300, CSR_MISA = 0x301, CSR_MIE = 0x304, CSR_MTVEC = 0x305,
+        CSR_MSCRATCH = 0x340, CSR_MEPC = 0x341, CSR_MCAUSE = 0x342
+    };
+
+    uint8_t* translate(uint32_t addr, uint32_t len);
+    bool fetch(uint32_t& instr, uint32_t& len);
+    bool step();                             // False: stop before this instruction
+    bool csr_read(uint32_t csr, uint32_t& value) const;
+    bool csr_write(uint32_t csr, uint32_t value);
+    static uint32_t expand(uint16_t c);      // RVC to RV32I, 0 if unsupported
+    uint32_t to_l2(uint32_t addr) const;
+    std::vector<uint32_t> trampoline(uint32_t at, uint32_t entry, uint32_t entry_word, uint32_t pc) const;
+
+    std::vector<uint8_t> mem_;
+    uint32_t base_;
+    uint32_t alias_base_;
+    bool ignore_mmio_;
+
+    uint32_t pc_;
+    uint32_t x_[32];
+    uint32_t mstatus_, mie_, mtvec_, mscratch_, mepc_, mcause_;
+    uint64_t instret_;
+    StopReason reason_;
+};
+
+#endif // ISS_H
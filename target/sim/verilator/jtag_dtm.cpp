@@ -0,0 +1,205 @@
+// Copyright 2025 Custom IP Integration
+// JTAG debug transport driven from the harness.
+
+#include "jtag_dtm.h"
+#include "tb_console.h"
+#include "tb_hier.h"
+#include <iomanip>
+#include <iostream>
+
+JtagDtm::JtagDtm(Vpulpissimo* top, DmiHost* host, unsigned bypass_ir_bits, unsigned bypass_dr_bits)
+    : top_(top), host_(host), bypass_ir_bits_(bypass_ir_bits), bypass_dr_bits_(bypass_dr_bits),
+      abits_(7), idle_(1), state_(START), pos_(0), tck_high_(false), captured_(0), captured_bits_(0),
+      scanning_dmi_(false), scan_word_(0), next_valid_(false), pending_(false),
+      dmi_ops_(0), busy_retries_(0), tck_cycles_(0) {
+    TB_PORT_JTAG_TCK(top_) = 0;
+    TB_PORT_JTAG_TMS(top_) = 1;
+    TB_PORT_JTAG_TDI(top_) = 0;
+    TB_PORT_JTAG_TRSTN(top_) = 0;
+}
+
+// TCK falls on one call and rises on the next. TMS and TDI change with the
+// rising edge they are sampled on; TDO was updated by the falling edge before.
+void JtagDtm::sample(uint64_t) {
+    if (tck_high_) {
+        TB_PORT_JTAG_TCK(top_) = 0;
+        tck_high_ = false;
+        return;
+    }
+    if (pos_ == bits_.size()) {
+        if (!bits_.empty()) finish_scan();
+        if (bits_.empty()) next_scan();
+        if (bits_.empty()) return;
+    }
+    clock_bit(bits_[pos_++]);
+}
+
+void JtagDtm::clock_bit(const Bit& b) {
+    if (b.capture && captured_bits_ < 64) {
+        captured_ |= (uint64_t)(TB_PORT_JTAG_TDO(top_) & 1) << captured_bits_;
+        captured_bits_++;
+    }
+    TB_PORT_JTAG_TMS(top_) = b.tms;
+    TB_PORT_JTAG_TDI(top_) = b.tdi;
+    TB_PORT_JTAG_TRSTN(top_) = b.trstn;
+    TB_PORT_JTAG_TCK(top_) = 1;
+    tck_high_ = true;
+    tck_cycles_++;
+}
+
+// Queue the bits of the next scan, if there is anything to do
+void JtagDtm::next_scan() {
+    switch (state_) {
+    case START:
+        queue_reset();
+        queue_ir(IR_DTMCS);
+        queue_dr(0, 32, true);
+        state_ = READ_DTMCS;
+        break;
+    case READY:
+        host_->tick();
+        if (host_->pending()) {
+            next_ = host_->front();
+            host_->pop();
+            next_valid_ = true;
+            scan_word_ = dmi_word(next_.op, next_.addr, next_.data);
+        } else if (pending_) {
+            // Nothing new to send, collect the last result with a nop
+            scan_word_ = dmi_word(DmiHost::OP_NOP, 0, 0);
+        } else {
+            break;
+        }
+        scanning_dmi_ = true;
+        queue_dr(scan_word_, abits_ + 34, true);
+        queue_idle(idle_);
+        break;
+    case DISABLED:
+        host_->tick();
+        while (host_->pending()) {
+            host_->respond(DmiHost::RESP_FAILED, host_->front().addr, 0);
+            host_->pop();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void JtagDtm::finish_scan() {
+    uint64_t dr = captured_ >> bypass_dr_bits_;
+    bits_.clear();
+    pos_ = 0;
+    captured_ = 0;
+    captured_bits_ = 0;
+
+    switch (state_) {
+    case READ_DTMCS: {
+        uint32_t dtmcs = (uint32_t)dr;
+        unsigned version = dtmcs & 0xF;
+        if (dtmcs == 0 || dtmcs == 0xFFFFFFFFu || version > 1) {
+            tb_err() << "Warning: No RISC-V debug TAP on the JTAG pins (dtmcs = 0x" << std::hex
+                      << dtmcs << std::dec << "), DMI requests will fail" << std::endl;
+            state_ = DISABLED;
+            break;
+        }
+        abits_ = (dtmcs >> 4) & 0x3F;
+        idle_ = (dtmcs >> 12) & 0x7;
+        tb_out() << "JTAG DTM: dtmcs 0x" << std::hex << std::setw(8) << std::setfill('0') << dtmcs
+                  << std::dec << std::setfill(' ') << ", " << abits_ << " address bits, "
+                  << idle_ << " idle cycles" << std::endl;
+        queue_ir(IR_DMIACCESS);
+        state_ = SELECT_DMI;
+        break;
+    }
+    case SELECT_DMI:
+        state_ = READY;
+        break;
+    case READY: {
+        if (!scanning_dmi_) break;
+        unsigned status = dr & 0x3;
+        if (status == 3) {
+            // The previous operation had not finished and this one was
+            // dropped. Clear the sticky busy, wait longer and try again.
+            busy_retries_++;
+            if (idle_ < MAX_IDLE) idle_++;
+            queue_dmireset();
+            queue_dr(scan_word_, abits_ + 34, true);
+            queue_idle(idle_);
+            break;
+        }
+        if (pending_) {
+            host_->respond(status == 0 ? DmiHost::RESP_OK : DmiHost::RESP_FAILED,
+                           pending_req_.addr, (uint32_t)(dr >> 2));
+            dmi_ops_++;
+            pending_ = false;
+            if (status != 0) {
+                // The sticky error made the DTM drop this scan's operation
+                queue_dmireset();
+                queue_dr(scan_word_, abits_ + 34, true);
+                queue_idle(idle_);
+                break;
+            }
+        }
+        pending_ = next_valid_;
+        pending_req_ = next_;
+        next_valid_ = false;
+        scanning_dmi_ = false;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// TRST and five TMS ones from any state, then Run-Test/Idle
+void JtagDtm::queue_reset() {
+    for (int i = 0; i < 4; i++) bits_.push_back({1, 0, 0, 0});
+    for (int i = 0; i < 5; i++) bits_.push_back({1, 0, 0, 1});
+    bits_.push_back({0, 0, 0, 1});
+}
+
+// From Run-Test/Idle through Shift-IR back to Run-Test/Idle. The TAPs
+// nearer TDO get their IR bits first and are put in BYPASS.
+void JtagDtm::queue_ir(uint32_t instr) {
+    bits_.push_back({1, 0, 0, 1});
+    bits_.push_back({1, 0, 0, 1});
+    bits_.push_back({0, 0, 0, 1});
+    bits_.push_back({0, 0, 0, 1});
+    uint64_t value = ((uint64_t)instr << bypass_ir_bits_) | ((1ull << bypass_ir_bits_) - 1);
+    unsigned total = IR_LEN + bypass_ir_bits_;
+    for (unsigned i = 0; i < total; i++) {
+        bits_.push_back({(uint8_t)(i == total - 1), (uint8_t)((value >> i) & 1), 0, 1});
+    }
+    bits_.push_back({1, 0, 0, 1});
+    bits_.push_back({0, 0, 0, 1});
+}
+
+// From Run-Test/Idle through Shift-DR back to Run-Test/Idle. With `capture`
+// the bits shifted out are collected, bypass bits first.
+void JtagDtm::queue_dr(uint64_t value, unsigned bits, bool capture) {
+    bits_.push_back({1, 0, 0, 1});
+    bits_.push_back({0, 0, 0, 1});
+    bits_.push_back({0, 0, 0, 1});
+    unsigned total = bits + bypass_dr_bits_;
+    for (unsigned i = 0; i < total; i++) {
+        uint8_t tdi = (i >= bypass_dr_bits_ && i - bypass_dr_bits_ < 64)
+            ? (uint8_t)((value >> (i - bypass_dr_bits_)) & 1) : 0;
+        bits_.push_back({(uint8_t)(i == total - 1), tdi, (uint8_t)capture, 1});
+    }
+    bits_.push_back({1, 0, 0, 1});
+    bits_.push_back({0, 0, 0, 1});
+}
+
+void JtagDtm::queue_idle(unsigned cycles) {
+    for (unsigned i = 0; i < cycles; i++) bits_.push_back({0, 0, 0, 1});
+}
+
+void JtagDtm::queue_dmireset() {
+    queue_ir(IR_DTMCS);
+    queue_dr(DTMCS_DMIRESET, 32, false);
+    queue_ir(IR_DMIACCESS);
+}
+
+uint64_t JtagDtm::dmi_word(uint8_t op, uint8_t addr, uint32_t data) const {
+    return ((uint64_t)addr << 34) | ((uint64_t)data << 2) | (op & 0x3);
+}
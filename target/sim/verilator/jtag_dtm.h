@@ -0,0 +1,100 @@
+// Copyright 2025 Custom IP Integration
+// JTAG debug transport driven from the harness.
+//
+// The Verilated pulpissimo has no SimDTM; its debug module is reached through
+// the RISC-V debug TAP on the pad_jtag_* ports. JtagDtm takes DMI operations
+// from a DmiHost (a DmiServer client or the GDB server) and turns them into
+// DR scans of the DMIACCESS register directly on those pins, one TCK period
+// per two main clock cycles. The bit
+// sequences are generated here, so the cost per DMI operation is ~50 TCK
+// periods of simulation and no host round trip, instead of a socket exchange
+// per bit with remote_bitbang and OpenOCD.
+//
+// Scans are pipelined as the DTM allows: the scan of an operation captures
+// the result of the previous one. A "busy" capture is answered with a
+// dmireset, more Run-Test/Idle cycles and a repeat of the scan.
+//
+// The default scan chain is the one of jtag_pkg.sv: the debug TAP (IR 5 bits)
+// at TDI followed by the legacy SoC TAP held in BYPASS (IR 5 bits, DR 1 bit).
+
+#ifndef JTAG_DTM_H
+#define JTAG_DTM_H
+
+#include "Vpulpissimo.h"
+#include "dmi_server.h"
+#include "sim_monitor.h"
+#include <cstdint>
+#include <vector>
+
+class JtagDtm : public SimMonitor {
+public:
+    // Debug TAP instructions (RISC-V debug spec, jtag_pkg.sv)
+    static const uint32_t IR_LEN = 5;
+    static const uint32_t IR_DTMCS = 0x10;
+    static const uint32_t IR_DMIACCESS = 0x11;
+    static const uint32_t IR_BYPASS = 0x1F;
+    static const uint32_t DTMCS_DMIRESET = 1u << 16;
+    static const unsigned MAX_IDLE = 64;           // Run-Test/Idle cycles after a DMI scan
+
+    // `bypass_ir_bits` and `bypass_dr_bits` describe the TAPs between the
+    // debug TAP and TDO, which are kept in BYPASS.
+    JtagDtm(Vpulpissimo* top, DmiHost* host, unsigned bypass_ir_bits = 5, unsigned bypass_dr_bits = 1);
+
+    void sample(uint64_t cycle) override;
+    bool stop_requested() const override { return host_->quit(); }
+
+    // No scan in progress and no DMI operation waiting
+    bool idle() const { return state_ == READY && pos_ == bits_.size() && !host_->pending() && !pending_; }
+
+    uint64_t dmi_ops() const { return dmi_ops_; }
+    uint64_t busy_retries() const { return busy_retries_; }
+    uint64_t tck_cycles() const { return tck_cycles_; }
+
+private:
+    enum State { START, READ_DTMCS, SELECT_DMI, READY, DISABLED };
+
+    struct Bit {
+        uint8_t tms;
+        uint8_t tdi;
+        uint8_t capture;  // Shift state: TDO carries a captured bit
+        uint8_t trstn;
+    };
+
+    void clock_bit(const Bit& b);
+    void next_scan();
+    void finish_scan();
+
+    void queue_reset();
+    void queue_ir(uint32_t instr);
+    void queue_dr(uint64_t value, unsigned bits, bool capture);
+    void queue_idle(unsigned cycles);
+    void queue_dmireset();
+    uint64_t dmi_word(uint8_t op, uint8_t addr, uint32_t data) const;
+
+    Vpulpissimo* top_;
+    DmiHost* host_;
+    unsigned bypass_ir_bits_;
+    unsigned bypass_dr_bits_;
+    unsigned abits_;
+    unsigned idle_;                  // Run-Test/Idle cycles after each DMI scan
+
+    State state_;
+    std::vector<Bit> bits_;          // Bits of the scan in progress
+    size_t pos_;
+    bool tck_high_;
+    uint64_t captured_;
+    unsigned captured_bits_;
+
+    bool scanning_dmi_;              // The scan in progress is a DMI access
+    uint64_t scan_word_;             // ... shifting this DMIACCESS value
+    bool next_valid_;                // ... for this request
+    DmiHost::Request next_;
+    bool pending_;                   // Request whose result the next capture holds
+    DmiHost::Request pending_req_;
+
+    uint64_t dmi_ops_;
+    uint64_t busy_retries_;
+    uint64_t tck_cycles_;
+};
+
+#endif // JTAG_DTM_H
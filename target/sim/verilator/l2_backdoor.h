@@ -0,0 +1,142 @@
+// Copyright 2025 Custom IP Integration
+// Backdoor access to the L2 SRAM banks of the Verilated pulpissimo model.
+//
+// Writes go straight into the tc_sram arrays exposed by --public-flat-rw, so
+// no clock cycles are spent and the interconnect is never touched. The address
+// decoding mirrors soc_mem_map.svh and l2_ram_multi_bank:
+//   0x1C000000 - 0x1C008000  private bank 0
+//   0x1C008000 - 0x1C010000  private bank 1
+//   0x1C010000 - 0x1C090000  interleaved banks, word-interleaved over 4 cuts
+
+#ifndef L2_BACKDOOR_H
+#define L2_BACKDOOR_H
+
+#include "Vpulpissimo.h"
+#include "tb_hier.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#define L2_PRI0_START_ADDR 0x1C000000
+#define L2_PRI1_START_ADDR 0x1C008000
+#define L2_INTL_START_ADDR 0x1C010000
+#define L2_INTL_END_ADDR   0x1C090000
+
+#define L2_PRI_BANK_WORDS  8192
+#define L2_INTL_NB_BANKS   4
+#define L2_INTL_BANK_WORDS 32768
+
+class L2Backdoor {
+public:
+    explicit L2Backdoor(Vpulpissimo* top) {
+        pri_[0] = &TB_L2_PRI0_BANK(top)[0];
+        pri_[1] = &TB_L2_PRI1_BANK(top)[0];
+        intl_[0] = &TB_L2_INTL_BANK(top, 0)[0];
+        intl_[1] = &TB_L2_INTL_BANK(top, 1)[0];
+        intl_[2] = &TB_L2_INTL_BANK(top, 2)[0];
+        intl_[3] = &TB_L2_INTL_BANK(top, 3)[0];
+    }
+
+    static bool contains(uint32_t addr) {
+        return addr >= L2_PRI0_START_ADDR && addr < L2_INTL_END_ADDR;
+    }
+
+    // Return a pointer to the SRAM word backing `addr`, or nullptr if the
+    // address is not in L2.
+    uint32_t* word_ptr(uint32_t addr) const {
+        if (!contains(addr)) return nullptr;
+        if (addr < L2_PRI1_START_ADDR) {
+            return &pri_[0][(addr - L2_PRI0_START_ADDR) >> 2];
+        }
+        if (addr < L2_INTL_START_ADDR) {
+            return &pri_[1][(addr - L2_PRI1_START_ADDR) >> 2];
+        }
+        uint32_t word = (addr - L2_INTL_START_ADDR) >> 2;
+        return &intl_[word % L2_INTL_NB_BANKS][word / L2_INTL_NB_BANKS];
+    }
+
+    // Merge `data` into the word at `addr` under the byte-enable mask `be`
+    bool write_word(uint32_t addr, uint32_t data, uint8_t be = 0xF) {
+        uint32_t* w = word_ptr(addr);
+        if (!w) return false;
+        if (be == 0xF) {
+            *w = data;
+        } else {
+            uint32_t mask = 0;
+            for (int i = 0; i < 4; i++) {
+                if (be & (1 << i)) mask |= 0xFFu << (i * 8);
+            }
+            *w = (*w & ~mask) | (data & mask);
+        }
+        return true;
+    }
+
+    bool read_word(uint32_t addr, uint32_t& data) const {
+        const uint32_t* w = word_ptr(addr);
+        if (!w) return false;
+        data = *w;
+        return true;
+    }
+
+    // Copy `len` bytes to `addr`, or zero-fill if `data` is nullptr. Returns
+    // the number of bytes that landed in L2. Private banks are contiguous and
+    // take a single memcpy; interleaved banks are filled word by word.
+    size_t write_block(uint32_t addr, const uint8_t* data, size_t len) {
+        size_t written = 0;
+        while (len > 0) {
+            uint32_t* w = word_ptr(addr & ~0x3u);
+            if ((addr & 0x3) || len < 4 || !w) {
+                size_t chunk = write_partial(addr, data, len);
+                if (w) written += chunk;
+                addr += chunk;
+                if (data) data += chunk;
+                len -= chunk;
+                continue;
+            }
+            uint32_t words = len / 4;
+            if (addr < L2_INTL_START_ADDR) {
+                uint32_t bank_end = addr < L2_PRI1_START_ADDR ? L2_PRI1_START_ADDR : L2_INTL_START_ADDR;
+                if (words > (bank_end - addr) / 4) words = (bank_end - addr) / 4;
+                if (data) {
+                    memcpy(w, data, words * 4);
+                } else {
+                    memset(w, 0, words * 4);
+                }
+            } else {
+                uint32_t avail = (L2_INTL_END_ADDR - addr) / 4;
+                if (words > avail) words = avail;
+                for (uint32_t i = 0; i < words; i++) {
+                    uint32_t v = 0;
+                    if (data) memcpy(&v, data + i * 4, 4);
+                    *word_ptr(addr + i * 4) = v;
+                }
+            }
+            written += words * 4;
+            addr += words * 4;
+            if (data) data += words * 4;
+            len -= words * 4;
+        }
+        return written;
+    }
+
+private:
+    // Write the bytes up to the next word boundary. Returns the byte count.
+    size_t write_partial(uint32_t addr, const uint8_t* data, size_t len) {
+        uint32_t offset = addr & 0x3;
+        size_t chunk = 4 - offset;
+        if (chunk > len) chunk = len;
+        uint32_t word = 0;
+        uint8_t be = 0;
+        for (size_t i = 0; i < chunk; i++) {
+            if (data) word |= (uint32_t)data[i] << ((offset + i) * 8);
+            be |= 1 << (offset + i);
+        }
+        write_word(addr & ~0x3u, word, be);
+        return chunk;
+    }
+
+    uint32_t* pri_[2];
+    uint32_t* intl_[L2_INTL_NB_BANKS];
+};
+
+#endif // L2_BACKDOOR_H
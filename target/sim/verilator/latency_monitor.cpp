@@ -0,0 +1,262 @@
+// Copyright 2025 Custom IP Integration
+// Interrupt and peripheral access latency histograms.
+
+#include "latency_monitor.h"
+#include "l2_backdoor.h"
+#include "tb_console.h"
+#include "tb_format.h"
+#include "tb_hier.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Core interrupt ids of the FC timer (ARCHI_FC_EVT_TIMER0_LO/HI)
+static const int FC_EVT_TIMER0_LO = 10;
+static const int FC_EVT_TIMER0_HI = 11;
+
+static const int MAX_BARS = 16;
+static const int BAR_WIDTH = 40;
+// Responses that never come (accesses of a model without r_valid) must not
+// grow the queue forever
+static const size_t MAX_OUTSTANDING = 16;
+
+// Peripheral slots of soc_mem_map (archi/chips/pulpissimo/memory_map.h)
+static const struct {
+    uint32_t base;
+    const char* name;
+} SLOTS[] = {
+    {0x1A100000, "soc_periph"},
+    {0x1A101000, "gpio"},
+    {0x1A102000, "udma"},
+    {0x1A103000, "udma"},
+    {0x1A104000, "soc_ctrl"},
+    {0x1A105000, "adv_timer"},
+    {0x1A106000, "soc_eu"},
+    {0x1A109000, "fc_itc"},
+    {0x1A10B000, "fc_timer"},
+    {0x1A10C000, "fc_hwpe"},
+    {0x1A10D000, "actuator"},
+    {0x1A10F000, "stdout"},
+    {0x1A120000, "fll"},
+    {0x1A121000, "pad_cfg"},
+    {0x1A122000, "actuator"},   // ACTUATOR_PORTS builds
+};
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    uint64_t target = (uint64_t)((p / 100.0) * n_ + 0.999999);
+    uint64_t seen = 0;
+    for (const auto& c : counts_) {
+        seen += c.second;
+        if (seen >= target) return c.first;
+    }
+    return max();
+}
+
+void LatencyHistogram::print_summary(std::ostream& os, const std::string& name) const {
+    os << "  " << std::left << std::setw(24) << name << std::right << std::setw(10) << n_
+       << std::setw(8) << min() << std::setw(10) << tb_fixed(mean(), 1)
+       << std::setw(8) << percentile(99) << std::setw(8) << max() << "\n";
+}
+
+void LatencyHistogram::print(std::ostream& os, const std::string& name) const {
+    print_summary(os, name);
+    // Exact values if they fit, power-of-two buckets otherwise
+    std::vector<std::pair<std::string, uint64_t>> bars;
+    if (counts_.size() <= (size_t)MAX_BARS) {
+        for (const auto& c : counts_) bars.emplace_back(std::to_string(c.first), c.second);
+    } else {
+        std::map<int, uint64_t> buckets;
+        for (const auto& c : counts_) {
+            int b = 0;
+            while (b < 63 && (2ull << b) <= c.first) b++;
+            buckets[c.first ? b + 1 : 0] += c.second;
+        }
+        for (const auto& b : buckets) {
+            std::string label = b.first ? std::to_string(1ull << (b.first - 1)) + "-" +
+                                          std::to_string((2ull << (b.first - 1)) - 1)
+                                        : "0";
+            bars.emplace_back(label, b.second);
+        }
+    }
+    uint64_t peak = 0;
+    for (const auto& b : bars) peak = std::max(peak, b.second);
+    for (const auto& b : bars) {
+        int width = peak ? (int)((b.second * BAR_WIDTH + peak - 1) / peak) : 0;
+        os << "    " << std::setw(20) << b.first << " " << std::setw(10) << b.second << " "
+           << std::string(width, '#') << "\n";
+    }
+}
+
+void LatencyHistogram::write_csv(std::ostream& os, const std::string& name) const {
+    for (const auto& c : counts_) os << name << "," << c.first << "," << c.second << "\n";
+}
+
+LatencyMonitor::LatencyMonitor(Vpulpissimo* top)
+    : top_(top), last_irqs_(0), isr_wait_(false), isr_id_(0), isr_rise_(0), ack_cycle_(0),
+      bus_(TB_FC_DATA_BUS(top)), in_request_(false), request_start_(0) {
+    std::fill(irq_rise_, irq_rise_ + NB_IRQS, 0);
+    add_source("timer_lo", &TB_TIMER_SIG(top, irq_lo_o), FC_EVT_TIMER0_LO);
+    add_source("timer_hi", &TB_TIMER_SIG(top, irq_hi_o), FC_EVT_TIMER0_HI);
+#ifdef TB_ACTUATOR_PORTS
+    add_source("actuator", &TB_PORT_ACTUATOR_IRQ(top), -1);
+#endif
+}
+
+void LatencyMonitor::add_source(const char* name, const CData* line, int id) {
+    Source s;
+    s.name = name;
+    s.line = line;
+    s.id = id;
+    s.last = s.pending = s.seen_line = s.taken = false;
+    s.rise = 0;
+    sources_.push_back(s);
+}
+
+void LatencyMonitor::set_actuator_id(int id) {
+    for (Source& s : sources_) {
+        if (s.name == "actuator") s.id = id;
+    }
+}
+
+void LatencyMonitor::sample(uint64_t cycle) {
+    sample_irqs(cycle);
+    if (bus_) sample_bus(cycle);
+}
+
+void LatencyMonitor::sample_irqs(uint64_t cycle) {
+    for (Source& s : sources_) {
+        bool level = *s.line & 1;
+        if (level && !s.last && !s.pending) {
+            s.pending = true;
+            s.seen_line = s.taken = false;
+            s.rise = cycle;
+        }
+        s.last = level;
+    }
+
+    uint32_t irqs = TB_FC_CORE_SIG(top_, irq_i);
+    for (uint32_t rose = irqs & ~last_irqs_; rose; rose &= rose - 1) {
+        irq_rise_[__builtin_ctz(rose)] = cycle;
+    }
+    last_irqs_ = irqs;
+    for (Source& s : sources_) {
+        if (s.pending && !s.seen_line && s.id >= 0 && (irqs >> s.id & 1)) {
+            s.seen_line = true;
+            s.to_line.add(cycle - s.rise);
+        }
+    }
+
+    // The handler's first instruction leaves ID after the acknowledge
+    if (isr_wait_ && cycle > ack_cycle_ && TB_FC_CORE_SIG(top_, instr_valid_id) && TB_FC_CORE_SIG(top_, id_valid)) {
+        isr_wait_ = false;
+        irq_isr_[isr_id_].add(cycle - isr_rise_);
+        for (Source& s : sources_) {
+            if (s.pending && s.taken) {
+                s.to_isr.add(cycle - s.rise);
+                s.pending = false;
+            }
+        }
+    }
+    if (TB_FC_CORE_SIG(top_, irq_ack_o)) {
+        int id = TB_FC_CORE_SIG(top_, irq_id_o) & (NB_IRQS - 1);
+        isr_wait_ = true;
+        isr_id_ = id;
+        isr_rise_ = (irqs >> id & 1) ? irq_rise_[id] : cycle;
+        ack_cycle_ = cycle;
+        for (Source& s : sources_) {
+            if (s.pending && !s.taken && (s.id < 0 || s.id == id)) {
+                s.taken = true;
+                s.to_take.add(cycle - s.rise);
+            }
+        }
+    }
+}
+
+void LatencyMonitor::sample_bus(uint64_t cycle) {
+    const Vpulpissimo_XBAR_TCDM_BUS* bus = bus_;
+    if (bus->r_valid && !outstanding_.empty()) {
+        const Access& a = outstanding_.front();
+        if (!L2Backdoor::contains(a.addr)) {
+            access_[slot_name(a.addr & ~0xFFFu) + (a.read ? ".read" : ".write")].add(cycle - a.start);
+        }
+        outstanding_.pop_front();
+    }
+    if (!bus->req) {
+        in_request_ = false;
+        return;
+    }
+    if (!in_request_) {
+        in_request_ = true;
+        request_start_ = cycle;
+    }
+    if (bus->gnt) {
+        Access a = {request_start_, bus->add, bus->wen != 0};
+        outstanding_.push_back(a);
+        if (outstanding_.size() > MAX_OUTSTANDING) outstanding_.pop_front();
+        in_request_ = false;
+    }
+}
+
+void LatencyMonitor::write_header(std::ostream& os) {
+    os << "  " << std::left << std::setw(24) << "" << std::right << std::setw(10) << "samples"
+       << std::setw(8) << "min" << std::setw(10) << "mean" << std::setw(8) << "p99"
+       << std::setw(8) << "max" << "\n";
+}
+
+std::string LatencyMonitor::slot_name(uint32_t addr) {
+    for (const auto& s : SLOTS) {
+        if (s.base == addr) return s.name;
+    }
+    std::ostringstream os;
+    os << "0x" << std::hex << addr;
+    return os.str();
+}
+
+// Non-empty histograms: sources, core interrupt ids, peripheral slots
+std::vector<std::pair<std::string, const LatencyHistogram*>> LatencyMonitor::histograms() const {
+    std::vector<std::pair<std::string, const LatencyHistogram*>> all;
+    for (const Source& s : sources_) {
+        if (s.to_line.count()) all.emplace_back(s.name + ".line", &s.to_line);
+        if (s.to_take.count()) all.emplace_back(s.name + ".take", &s.to_take);
+        if (s.to_isr.count()) all.emplace_back(s.name + ".isr", &s.to_isr);
+    }
+    for (const auto& h : irq_isr_) all.emplace_back("irq" + std::to_string(h.first) + ".isr", &h.second);
+    for (const auto& h : access_) all.emplace_back(h.first, &h.second);
+    return all;
+}
+
+void LatencyMonitor::print_summary() const {
+    auto all = histograms();
+    if (all.empty()) {
+        tb_out() << "Latency: no interrupts taken, no peripheral accesses" << std::endl;
+        return;
+    }
+    tb_out() << "Latency (cycles):" << std::endl;
+    write_header(tb_out());
+    for (const auto& h : all) h.second->print_summary(tb_out(), h.first);
+    tb_out().flush();
+}
+
+bool LatencyMonitor::write(const std::string& prefix) const {
+    auto all = histograms();
+    std::ofstream txt(prefix + ".txt");
+    if (!txt) return false;
+    write_header(txt);
+    for (const auto& h : all) {
+        h.second->print(txt, h.first);
+        txt << "\n";
+    }
+    std::ofstream csv(prefix + ".csv");
+    if (!csv) return false;
+    csv << "name,cycles,count\n";
+    for (const auto& h : all) h.second->write_csv(csv, h.first);
+    return txt.good() && csv.good();
+}
+
+std::vector<std::pair<std::string, uint64_t>> LatencyMonitor::p99() const {
+    std::vector<std::pair<std::string, uint64_t>> values;
+    for (const auto& h : histograms()) values.emplace_back(h.first, h.second->percentile(99));
+    return values;
+}
@@ -0,0 +1,134 @@
+// Copyright 2025 Custom IP Integration
+// Interrupt and peripheral access latency histograms.
+//
+// Interrupts are timestamped at every stage the harness can see:
+//   source  the request line of a known source rises: FC timer compare
+//           (irq_lo_o/irq_hi_o of apb_timer_unit) and, in VERILATOR_ACTUATOR
+//           builds, custom_actuator_ctrl's interrupt_o exported as
+//           actuator_irq_o (pulpissimo.sv does not route it to the core, so
+//           its later stages only mean something on an RTL that does)
+//   line    the interrupt controller raises the source's irq_i bit of the core
+//   take    the core acknowledges it (irq_ack_o with irq_id_o)
+//   isr     the first instruction after the acknowledge leaves the ID stage,
+//           i.e. the first instruction of the handler (or of its vector slot)
+// Every core interrupt id gets a line -> isr histogram, whatever its source;
+// known sources also get source -> line/take/isr. Latencies are in SoC clock
+// cycles and include time spent with interrupts disabled or in wfi.
+//
+// Peripheral accesses are measured on the FC data port from the first cycle
+// of the request to its response (r_valid), so the interconnect and APB
+// bridge are included, as firmware sees them. They are grouped by the 4 KiB
+// peripheral slot of soc_mem_map and by direction.
+
+#ifndef LATENCY_MONITOR_H
+#define LATENCY_MONITOR_H
+
+#include "Vpulpissimo.h"
+#include "Vpulpissimo_XBAR_TCDM_BUS.h"
+#include "sim_monitor.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Exact distribution of small integer latencies
+class LatencyHistogram {
+public:
+    LatencyHistogram() : n_(0), sum_(0) {}
+
+    void add(uint64_t v) {
+        counts_[v]++;
+        n_++;
+        sum_ += v;
+    }
+
+    uint64_t count() const { return n_; }
+    uint64_t min() const { return n_ ? counts_.begin()->first : 0; }
+    uint64_t max() const { return n_ ? counts_.rbegin()->first : 0; }
+    double mean() const { return n_ ? (double)sum_ / n_ : 0.0; }
+    // Smallest latency that at least `p` percent of the samples do not exceed
+    uint64_t percentile(double p) const;
+
+    // One summary line, then a bar per value (or per power-of-two bucket)
+    void print(std::ostream& os, const std::string& name) const;
+    void print_summary(std::ostream& os, const std::string& name) const;
+    void write_csv(std::ostream& os, const std::string& name) const;
+
+private:
+    std::map<uint64_t, uint64_t> counts_;
+    uint64_t n_;
+    uint64_t sum_;
+};
+
+class LatencyMonitor : public SimMonitor {
+public:
+    static const int NB_IRQS = 32;
+
+    explicit LatencyMonitor(Vpulpissimo* top);
+
+    // Core interrupt id of custom_actuator_ctrl; -1 (default) matches the
+    // first interrupt taken after the source rises
+    void set_actuator_id(int id);
+
+    void sample(uint64_t cycle) override;
+
+    // Summary line of every histogram
+    void print_summary() const;
+
+    // Write <prefix>.txt (histograms) and <prefix>.csv (name,cycles,count).
+    // Returns false on I/O error.
+    bool write(const std::string& prefix) const;
+
+    // 99th percentile of every histogram, for the run report
+    std::vector<std::pair<std::string, uint64_t>> p99() const;
+
+private:
+    struct Source {
+        std::string name;
+        const CData* line;          // Source request line
+        int id;                     // Core interrupt id, -1 = any
+        bool last;
+        bool pending;               // Rose, handler not reached yet
+        bool seen_line;
+        bool taken;
+        uint64_t rise;
+        LatencyHistogram to_line, to_take, to_isr;
+    };
+
+    struct Access {
+        uint64_t start;
+        uint32_t addr;
+        bool read;
+    };
+
+    void add_source(const char* name, const CData* line, int id);
+    void sample_irqs(uint64_t cycle);
+    void sample_bus(uint64_t cycle);
+    std::vector<std::pair<std::string, const LatencyHistogram*>> histograms() const;
+    static std::string slot_name(uint32_t addr);
+    static void write_header(std::ostream& os);
+
+    Vpulpissimo* top_;
+    std::vector<Source> sources_;
+
+    // Core interrupt lines
+    uint32_t last_irqs_;
+    uint64_t irq_rise_[NB_IRQS];
+    bool isr_wait_;                 // Acknowledged, waiting for the first instruction
+    int isr_id_;
+    uint64_t isr_rise_;             // Line rise of the acknowledged interrupt
+    uint64_t ack_cycle_;
+    std::map<int, LatencyHistogram> irq_isr_;
+
+    // FC data port, responses in request order
+    const Vpulpissimo_XBAR_TCDM_BUS* bus_;
+    bool in_request_;
+    uint64_t request_start_;
+    std::deque<Access> outstanding_;
+    std::map<std::string, LatencyHistogram> access_; // By <slot>.read/.write
+};
+
+#endif // LATENCY_MONITOR_H
@@ -0,0 +1,123 @@
+// Copyright 2025 Custom IP Integration
+// Sparse, page-granular memory image for program loading.
+//
+// Bytes are stored in 4 KB pages kept in one flat vector, with a bitmap per
+// page recording which bytes were actually written. Loaders walk the image as
+// contiguous runs of written bytes instead of visiting individual bytes.
+
+#ifndef MEMORY_IMAGE_H
+#define MEMORY_IMAGE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+class MemoryImage {
+public:
+    static const uint32_t PAGE_BITS = 12;
+    static const uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+
+    MemoryImage() : last_page_(UINT32_MAX), last_index_(0), bytes_(0) {}
+
+    void write(uint32_t addr, const uint8_t* data, size_t len) {
+        while (len > 0) {
+            uint32_t offset = addr & (PAGE_SIZE - 1);
+            size_t chunk = PAGE_SIZE - offset;
+            if (chunk > len) chunk = len;
+            Page& p = page(addr >> PAGE_BITS);
+            memcpy(p.data + offset, data, chunk);
+            for (size_t i = offset; i < offset + chunk; i++) {
+                uint64_t bit = 1ULL << (i & 63);
+                if (!(p.valid[i >> 6] & bit)) {
+                    p.valid[i >> 6] |= bit;
+                    bytes_++;
+                }
+            }
+            addr += chunk;
+            data += chunk;
+            len -= chunk;
+        }
+    }
+
+    // Number of distinct bytes written
+    size_t size() const { return bytes_; }
+    bool empty() const { return bytes_ == 0; }
+
+    // Call fn(addr, data, len) for every run of written bytes, in address
+    // order. `data` points into the image and stays valid while it is alive.
+    template <typename Fn>
+    void for_each_run(Fn fn) const {
+        std::vector<uint32_t> order(pages_.size());
+        for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return pages_[a].number < pages_[b].number;
+        });
+        for (uint32_t idx : order) {
+            const Page& p = pages_[idx];
+            uint32_t i = 0;
+            while (i < PAGE_SIZE) {
+                if (!is_valid(p, i)) {
+                    // Skip empty 64-byte groups quickly
+                    if ((i & 63) == 0 && p.valid[i >> 6] == 0) {
+                        i += 64;
+                    } else {
+                        i++;
+                    }
+                    continue;
+                }
+                uint32_t start = i;
+                while (i < PAGE_SIZE) {
+                    if ((i & 63) == 0 && p.valid[i >> 6] == ~0ULL) {
+                        i += 64;
+                    } else if (is_valid(p, i)) {
+                        i++;
+                    } else {
+                        break;
+                    }
+                }
+                fn((p.number << PAGE_BITS) + start, p.data + start, (size_t)(i - start));
+            }
+        }
+    }
+
+private:
+    struct Page {
+        uint32_t number;
+        uint64_t valid[PAGE_SIZE / 64];
+        uint8_t data[PAGE_SIZE];
+    };
+
+    static bool is_valid(const Page& p, uint32_t i) {
+        return (p.valid[i >> 6] >> (i & 63)) & 1;
+    }
+
+    Page& page(uint32_t number) {
+        if (number == last_page_) return pages_[last_index_];
+        auto it = index_.find(number);
+        uint32_t idx;
+        if (it == index_.end()) {
+            idx = pages_.size();
+            pages_.emplace_back();
+            Page& p = pages_.back();
+            p.number = number;
+            memset(p.valid, 0, sizeof(p.valid));
+            memset(p.data, 0, sizeof(p.data));
+            index_[number] = idx;
+        } else {
+            idx = it->second;
+        }
+        last_page_ = number;
+        last_index_ = idx;
+        return pages_[idx];
+    }
+
+    std::vector<Page> pages_;
+    std::unordered_map<uint32_t, uint32_t> index_;
+    uint32_t last_page_;
+    uint32_t last_index_;
+    size_t bytes_;
+};
+
+#endif // MEMORY_IMAGE_H
@@ -0,0 +1,229 @@
+// Copyright 2025 Custom IP Integration
+// DC motor plant closing the loop around custom_actuator_ctrl.
+
+#include "motor_plant.h"
+#include "tb_console.h"
+#include "tb_hier.h"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+static const double TWO_PI = 2 * 3.14159265358979323846;
+static const double STOPPED_RAD_S = 1e-6;   // Below this the rotor is held by dry friction
+
+static const struct {
+    const char* name;
+    double MotorParams::*field;
+} PARAM_KEYS[] = {
+    {"supply_v", &MotorParams::supply_v},
+    {"r_ohm", &MotorParams::r_ohm},
+    {"l_h", &MotorParams::l_h},
+    {"kt", &MotorParams::kt},
+    {"j", &MotorParams::j},
+    {"b", &MotorParams::b},
+    {"coulomb_nm", &MotorParams::coulomb_nm},
+    {"load_nm", &MotorParams::load_nm},
+    {"step_us", &MotorParams::step_us},
+    {"cpr", &MotorParams::cpr},
+    {"feedback", &MotorParams::feedback},
+    {"velocity_window_us", &MotorParams::velocity_window_us},
+    {"adc_bits", &MotorParams::adc_bits},
+    {"adc_range_a", &MotorParams::adc_range_a},
+    {"target", &MotorParams::target},
+    {"band", &MotorParams::band},
+    {"trace_every", &MotorParams::trace_every},
+};
+
+bool MotorParams::set(const std::string& key, double value) {
+    for (const auto& k : PARAM_KEYS) {
+        if (key == k.name) {
+            this->*k.field = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MotorParams::load(const std::string& path) {
+    std::ifstream is(path);
+    if (!is) {
+        tb_err() << "Error: Cannot open motor parameter file " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    for (int n = 1; std::getline(is, line); n++) {
+        line = line.substr(0, line.find('#'));
+        size_t eq = line.find('=');
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) continue;
+        std::string key = eq == std::string::npos ? "" : line.substr(first, eq - first);
+        key = key.substr(0, key.find_last_not_of(" \t") + 1);
+        const char* value = line.c_str() + eq + 1;
+        char* end = nullptr;
+        double v = eq == std::string::npos ? 0 : strtod(value, &end);
+        if (key.empty() || end == value || !set(key, v)) {
+            tb_err() << "Error: " << path << ":" << n << ": bad motor parameter line: " << line << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void MotorParams::print(std::ostream& os) const {
+    for (const auto& k : PARAM_KEYS) os << k.name << " = " << this->*k.field << "\n";
+    os.flush();
+}
+
+MotorPlant::MotorPlant(Vpulpissimo* top, const ClockScheduler& sched, const MotorParams& params)
+    : top_(top), sched_(sched), p_(params), start_us_(sched.time_ps() / 1e6),
+      step_ps_((uint64_t)std::max(1.0, params.step_us * 1e6)), next_step_ps_(sched.time_ps() + step_ps_),
+      duty_sum_(0), duty_cycles_(0), enabled_cycles_(0), last_duty_(0), last_enable_(false),
+      i_(0), w_(0), theta_(0), steps_(0), counts_(0), window_start_counts_(0), next_window_step_(0),
+      feedback_(0), enable_cycle_(0), enable_us_(0), settle_us_(-1), peak_(0), trace_(nullptr) {
+    if (p_.trace_every < 1) p_.trace_every = 1;
+    update_feedback();
+}
+
+MotorPlant::~MotorPlant() {
+    if (trace_) fclose(trace_);
+}
+
+bool MotorPlant::open_trace(const std::string& path) {
+    trace_ = fopen(path.c_str(), "w");
+    if (!trace_) return false;
+    fprintf(trace_, "time_us,duty,current_a,speed_rpm,position_rev,feedback\n");
+    return true;
+}
+
+// Average the command over the cycles of a step; integrate once simulated
+// time has passed the step boundary. A main clock slower than the step holds
+// the last command.
+void MotorPlant::sample(uint64_t cycle) {
+#ifdef TB_ACTUATOR_PORTS
+    bool enable = TB_PORT_ACTUATOR_ENABLE(top_) & 1;
+    double duty = TB_PORT_ACTUATOR_PWM(top_) / 65535.0;
+    if (TB_PORT_ACTUATOR_DIR(top_) & 1) duty = -duty;
+    if (enable) {
+        duty_sum_ += duty;
+        enabled_cycles_++;
+        if (!enable_cycle_) {
+            enable_cycle_ = cycle;
+            enable_us_ = sched_.time_ps() / 1e6;
+        }
+    }
+    duty_cycles_++;
+#else
+    (void)cycle;
+#endif
+
+    if (sched_.time_ps() < next_step_ps_) return;
+    if (duty_cycles_) {
+        last_duty_ = enabled_cycles_ ? duty_sum_ / enabled_cycles_ : 0.0;
+        last_enable_ = enabled_cycles_ * 2 >= duty_cycles_;
+    }
+    duty_sum_ = 0;
+    duty_cycles_ = 0;
+    enabled_cycles_ = 0;
+    while (sched_.time_ps() >= next_step_ps_) {
+        step(last_duty_, last_enable_, p_.step_us * 1e-6);
+        next_step_ps_ += step_ps_;
+    }
+
+#ifdef TB_ACTUATOR_PORTS
+    TB_PORT_ACTUATOR_FEEDBACK(top_) = feedback_;
+#endif
+}
+
+void MotorPlant::step(double duty, bool enable, double dt) {
+    // Electrical: exact solution for a constant voltage over the step. With
+    // the bridge off the freewheel diodes put the supply against the current
+    // until it reaches zero.
+    double emf = p_.kt * w_;
+    double v;
+    if (enable) {
+        v = duty * p_.supply_v;
+    } else if (i_ != 0) {
+        v = i_ > 0 ? -p_.supply_v : p_.supply_v;
+    } else {
+        v = emf;  // Open circuit
+    }
+    double i_ss = (v - emf) / p_.r_ohm;
+    double i_next = i_ss + (i_ - i_ss) * std::exp(-p_.r_ohm * dt / p_.l_h);
+    if (!enable && (i_next > 0) != (i_ > 0)) i_next = 0;
+    i_ = i_next;
+
+    // Mechanical: dry friction holds a stopped rotor until the drive torque
+    // breaks it away, and stops a rotor that would reverse within the step
+    double drive = p_.kt * i_ - p_.load_nm;
+    if (std::fabs(w_) < STOPPED_RAD_S) {
+        if (std::fabs(drive) <= p_.coulomb_nm) {
+            w_ = 0;
+        } else {
+            w_ += (drive - std::copysign(p_.coulomb_nm, drive)) / p_.j * dt;
+        }
+    } else {
+        double w_next = w_ + (drive - p_.b * w_ - std::copysign(p_.coulomb_nm, w_)) / p_.j * dt;
+        if ((w_next > 0) != (w_ > 0) && std::fabs(drive) <= p_.coulomb_nm) w_next = 0;
+        theta_ += 0.5 * (w_ + w_next) * dt;
+        w_ = w_next;
+    }
+    steps_++;
+
+    update_feedback();
+    measure();
+
+    if (trace_ && steps_ % (uint64_t)p_.trace_every == 0) {
+        fprintf(trace_, "%.3f,%.5f,%.5f,%.3f,%.6f,%u\n", time_us(), enable ? duty : 0.0, i_,
+                speed_rpm(), position_rev(), feedback_);
+    }
+}
+
+void MotorPlant::update_feedback() {
+    counts_ = (int64_t)std::floor(theta_ / TWO_PI * p_.cpr);
+    switch ((int)p_.feedback) {
+    case 1: {
+        // Counts moved in the last full window, two's complement
+        uint64_t window = (uint64_t)std::max(1.0, p_.velocity_window_us / p_.step_us);
+        if (steps_ >= next_window_step_) {
+            feedback_ = (uint16_t)(counts_ - window_start_counts_);
+            window_start_counts_ = counts_;
+            next_window_step_ = steps_ + window;
+        }
+        break;
+    }
+    case 2: {
+        double max_code = std::ldexp(1.0, (int)p_.adc_bits) - 1;
+        double code = std::round((i_ / p_.adc_range_a + 1) / 2 * max_code);
+        feedback_ = (uint16_t)std::min(std::max(code, 0.0), max_code);
+        break;
+    }
+    default:
+        feedback_ = (uint16_t)counts_;
+        break;
+    }
+}
+
+// Settling is measured on the feedback as firmware sees it, signed for
+// velocity and unwrapped for position
+void MotorPlant::measure() {
+    if (!measuring() || !enable_cycle_) return;
+    double value;
+    switch ((int)p_.feedback) {
+    case 1: value = (int16_t)feedback_; break;
+    case 2: value = feedback_; break;
+    default: value = (double)counts_; break;
+    }
+    if (value > peak_) peak_ = value;
+    double band = std::max(1.0, p_.band * std::fabs(p_.target));
+    if (std::fabs(value - p_.target) <= band) {
+        if (settle_us_ < 0) settle_us_ = time_us() - enable_us_;
+    } else {
+        settle_us_ = -1;
+    }
+}
+
+double MotorPlant::overshoot() const {
+    if (!measuring() || p_.target <= 0 || peak_ <= p_.target) return 0.0;
+    return (peak_ - p_.target) / p_.target;
+}
@@ -0,0 +1,124 @@
+// Copyright 2025 Custom IP Integration
+// DC motor plant closing the loop around custom_actuator_ctrl.
+//
+// The actuator outputs drive the motor terminals: actuator_pwm_o is the duty
+// cycle (0xFFFF = full supply voltage), actuator_dir_o the polarity and
+// actuator_enable_o the bridge enable. The duty is averaged over every main
+// clock cycle of a fixed simulated time step, then the motor is integrated
+// over that step:
+//
+//   L di/dt = V - R i - ke w
+//   J dw/dt = kt i - b w - coulomb friction - load torque
+//
+// The bridge is disabled when enable is low; the current then decays through
+// the freewheel diodes. sensor_feedback_i gets the encoder count, the encoder
+// velocity or an ADC reading of the winding current.
+//
+// Parameters come from a file of `key = value` lines ('#' starts a comment)
+// and can be overridden one by one, so a sweep only needs different
+// plusargs per run. Settling time is measured against a target in feedback
+// units and reported at the end of the run.
+//
+// The Verilated pulpissimo only has the actuator ports once the peripheral
+// is wired to the top level (CUSTOM_IP_INTEGRATION_GUIDE.md, step 2) and the
+// model is built with VERILATOR_ACTUATOR=1.
+
+#ifndef MOTOR_PLANT_H
+#define MOTOR_PLANT_H
+
+#include "Vpulpissimo.h"
+#include "clock_scheduler.h"
+#include "sim_monitor.h"
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+struct MotorParams {
+    double supply_v = 12.0;         // Bridge supply
+    double r_ohm = 1.2;             // Winding resistance
+    double l_h = 0.5e-3;            // Winding inductance
+    double kt = 0.02;               // Torque constant, Nm/A (= back-EMF constant, V s/rad)
+    double j = 2e-5;                // Rotor plus load inertia, kg m^2
+    double b = 1e-5;                // Viscous friction, Nm s/rad
+    double coulomb_nm = 1e-3;       // Dry friction (also the breakaway torque)
+    double load_nm = 0.0;           // Constant load torque, opposes positive rotation
+    double step_us = 1.0;           // Integration step in simulated time
+    double cpr = 4096;              // Encoder counts per revolution (after quadrature)
+    double feedback = 0;            // 0 = encoder position, 1 = velocity, 2 = current
+    double velocity_window_us = 1000; // Velocity feedback: counts per window
+    double adc_bits = 12;           // Current feedback: ADC resolution
+    double adc_range_a = 10.0;      // ... full scale is +-adc_range_a, offset binary
+    double target = -1;             // Settling target in feedback units, -1 = no measurement
+    double band = 0.02;             // Settling band, fraction of the target
+    double trace_every = 10;        // Trace one line per this many steps
+
+    // `key = value` lines; returns false and prints the line on errors
+    bool load(const std::string& path);
+    // One parameter by name; returns false for unknown keys
+    bool set(const std::string& key, double value);
+    void print(std::ostream& os) const;
+};
+
+class MotorPlant : public SimMonitor {
+public:
+    MotorPlant(Vpulpissimo* top, const ClockScheduler& sched, const MotorParams& params);
+    ~MotorPlant();
+
+    // CSV of the plant state every trace_every steps
+    bool open_trace(const std::string& path);
+
+    void sample(uint64_t cycle) override;
+
+    double time_us() const { return start_us_ + steps_ * p_.step_us; }
+    double position_rev() const { return theta_ / (2 * 3.14159265358979323846); }
+    double speed_rpm() const { return w_ * 60 / (2 * 3.14159265358979323846); }
+    double current_a() const { return i_; }
+    uint16_t feedback() const { return feedback_; }
+
+    // Settling against params.target, from the first enabled cycle. Negative
+    // when the target was never reached or left the band at the end.
+    bool measuring() const { return p_.target >= 0; }
+    double settle_us() const { return settle_us_; }
+    double overshoot() const;       // Fraction of the target
+    uint64_t enable_cycle() const { return enable_cycle_; }
+
+private:
+    void step(double duty, bool enable, double dt);
+    void update_feedback();
+    void measure();
+
+    Vpulpissimo* top_;
+    const ClockScheduler& sched_;
+    MotorParams p_;
+    double start_us_;
+    uint64_t step_ps_;
+    uint64_t next_step_ps_;
+
+    // Actuator command averaged over the current step
+    double duty_sum_;
+    uint64_t duty_cycles_;
+    uint64_t enabled_cycles_;
+    double last_duty_;
+    bool last_enable_;
+
+    // Plant state
+    double i_;                      // A
+    double w_;                      // rad/s
+    double theta_;                  // rad
+    uint64_t steps_;
+    int64_t counts_;
+    int64_t window_start_counts_;
+    uint64_t next_window_step_;
+    uint16_t feedback_;
+
+    // Settling measurement
+    uint64_t enable_cycle_;         // 0 = never enabled
+    double enable_us_;
+    double settle_us_;              // Last time the feedback entered the band, -1 outside
+    double peak_;
+
+    FILE* trace_;
+};
+
+#endif // MOTOR_PLANT_H
@@ -0,0 +1,138 @@
+// Copyright 2025 Custom IP Integration
+// FC performance counters collected by the harness.
+//
+// The events of pcer_v2.h are counted from the same strobes that feed the
+// cv32e40p hpm counters, so every event is available at once without any
+// firmware setup. Events the core does not implement (the EXT accesses and
+// TCDM contention) are derived from the FC data port. The RTL mcycle and
+// minstret registers are read back at the end for cross-checking.
+//
+// Counts can be frozen at a bus write (normally the benchmark's result
+// marker) so that the report covers the benchmark and not the idle tail.
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "Vpulpissimo.h"
+#include "Vpulpissimo_XBAR_TCDM_BUS.h"
+#include "bus_snooper.h"
+#include "l2_backdoor.h"
+#include "sim_monitor.h"
+#include "tb_console.h"
+#include "tb_format.h"
+#include "tb_hier.h"
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// Event ids as in sw/bootcode/include/archi/riscv/pcer_v2.h
+enum PcerEvent {
+    PCER_CYCLES, PCER_INSTR, PCER_LD_STALL, PCER_JMP_STALL, PCER_IMISS,
+    PCER_LD, PCER_ST, PCER_JUMP, PCER_BRANCH, PCER_TAKEN_BRANCH, PCER_RVC,
+    PCER_ELW, PCER_LD_EXT, PCER_ST_EXT, PCER_LD_EXT_CYC, PCER_ST_EXT_CYC,
+    PCER_TCDM_CONT, PCER_NB_EVENTS
+};
+
+static const char* const PCER_NAMES[PCER_NB_EVENTS] = {
+    "Cycles", "Instructions", "LD_Stall", "Jmp_Stall", "IMISS", "LD", "ST",
+    "JUMP", "BRANCH", "TAKEN_BRANCH", "RVC", "ELW", "LD_EXT", "ST_EXT",
+    "LD_EXT_CYC", "ST_EXT_CYC", "TCDM_CONT"
+};
+
+class PerfCounters : public SimMonitor {
+public:
+    explicit PerfCounters(Vpulpissimo* top)
+        : top_(top), snooper_(nullptr), freeze_watch_(-1), frozen_(false), frozen_cycle_(0) {
+        data_bus_ = TB_FC_DATA_BUS(top);
+        memset(counts_, 0, sizeof(counts_));
+    }
+
+    // Stop counting once `watch` of `snooper` has been written
+    void freeze_on_write(const BusSnooper* snooper, int watch) {
+        snooper_ = snooper;
+        freeze_watch_ = watch;
+    }
+
+    void sample(uint64_t cycle) override {
+        if (frozen_) return;
+        if (freeze_watch_ >= 0 && snooper_->get_watch(freeze_watch_).written) {
+            frozen_ = true;
+            frozen_cycle_ = cycle;
+            return;
+        }
+        // The hpm counters run on the gated core clock
+        if (TB_FC_CORE_SIG(top_, core_sleep_o)) return;
+
+        counts_[PCER_CYCLES]++;
+        counts_[PCER_INSTR] += TB_FC_EVENT(top_, minstret);
+        counts_[PCER_LD_STALL] += TB_FC_EVENT(top_, ld_stall);
+        counts_[PCER_JMP_STALL] += TB_FC_EVENT(top_, jr_stall);
+        counts_[PCER_IMISS] += TB_FC_EVENT(top_, imiss);
+        counts_[PCER_LD] += TB_FC_EVENT(top_, load);
+        counts_[PCER_ST] += TB_FC_EVENT(top_, store);
+        counts_[PCER_JUMP] += TB_FC_EVENT(top_, jump);
+        counts_[PCER_BRANCH] += TB_FC_EVENT(top_, branch);
+        counts_[PCER_TAKEN_BRANCH] += TB_FC_EVENT(top_, branch_taken);
+        counts_[PCER_RVC] += TB_FC_EVENT(top_, compressed);
+        counts_[PCER_ELW] += TB_FC_EVENT(top_, pipe_stall);
+
+        // Not implemented by the core: anything outside L2 counts as EXT
+        const Vpulpissimo_XBAR_TCDM_BUS* bus = data_bus_;
+        if (bus->req) {
+            bool ext = !L2Backdoor::contains(bus->add);
+            bool load = bus->wen;
+            if (ext) counts_[load ? PCER_LD_EXT_CYC : PCER_ST_EXT_CYC]++;
+            if (bus->gnt) {
+                if (ext) counts_[load ? PCER_LD_EXT : PCER_ST_EXT]++;
+            } else {
+                counts_[PCER_TCDM_CONT]++;
+            }
+        }
+    }
+
+    uint64_t count(int event) const { return counts_[event]; }
+    bool frozen() const { return frozen_; }
+    uint64_t frozen_cycle() const { return frozen_cycle_; }
+
+    // RTL counters; only meaningful if firmware left them uninhibited
+    uint64_t rtl_mcycle() const { return TB_FC_CSR_SIG(top_, mhpmcounter_q)[0]; }
+    uint64_t rtl_minstret() const { return TB_FC_CSR_SIG(top_, mhpmcounter_q)[2]; }
+    uint32_t rtl_inhibit() const { return TB_FC_CSR_SIG(top_, mcountinhibit_q); }
+
+    double ipc() const { return ratio(PCER_INSTR); }
+    double ratio(int event) const {
+        return counts_[PCER_CYCLES] ? (double)counts_[event] / counts_[PCER_CYCLES] : 0.0;
+    }
+
+    void print() const {
+        tb_out() << "FC performance counters";
+        if (frozen_) tb_out() << " (until cycle " << frozen_cycle_ << ")";
+        tb_out() << ":" << std::endl;
+        for (int i = 0; i < PCER_NB_EVENTS; i++) {
+            tb_out() << "  " << std::left << std::setw(14) << PCER_NAMES[i] << std::right
+                      << std::setw(14) << counts_[i] << std::endl;
+        }
+        tb_out() << "  IPC " << tb_fixed(ipc(), 3) << ", CPI "
+                  << tb_fixed(counts_[PCER_INSTR] ? (double)counts_[PCER_CYCLES] / counts_[PCER_INSTR] : 0.0, 3)
+                  << std::endl;
+        tb_out() << "  Stall ratio: load-use " << tb_fixed(ratio(PCER_LD_STALL), 3)
+                  << ", jump-register " << tb_fixed(ratio(PCER_JMP_STALL), 3)
+                  << ", fetch " << tb_fixed(ratio(PCER_IMISS), 3)
+                  << ", TCDM contention " << tb_fixed(ratio(PCER_TCDM_CONT), 3) << std::endl;
+        uint32_t inhibit = rtl_inhibit();
+        tb_out() << "  RTL mcycle " << (inhibit & 0x1 ? "(inhibited) " : "") << rtl_mcycle()
+                  << ", minstret " << (inhibit & 0x4 ? "(inhibited) " : "") << rtl_minstret() << std::endl;
+    }
+
+private:
+    Vpulpissimo* top_;
+    Vpulpissimo_XBAR_TCDM_BUS* data_bus_;
+    const BusSnooper* snooper_;
+    int freeze_watch_;
+    bool frozen_;
+    uint64_t frozen_cycle_;
+    uint64_t counts_[PCER_NB_EVENTS];
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,207 @@
+// Copyright 2025 Custom IP Integration
+// Cycle-attribution profiler for firmware running on the FC core.
+
+#include "profiler.h"
+#include "tb_console.h"
+#include "tb_format.h"
+#include "tb_hier.h"
+#include <elf.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+static const char* CATEGORY_NAMES[Profiler::NUM_CATEGORIES] = {
+    "exec", "ld", "jr", "imiss", "pipe", "sleep", "other"
+};
+
+Profiler::Profiler(Vpulpissimo* top, const ElfImage& elf)
+    : top_(top), unknown_(0), last_(0), call_pending_(false), ret_pending_(false), total_(0) {
+    for (const ElfImage::Symbol& s : elf.symbols()) {
+        if (s.type != STT_FUNC || s.size == 0) continue;
+        Function f;
+        f.name = s.name;
+        f.lo = s.addr;
+        f.hi = s.addr + s.size;
+        functions_.push_back(f);
+    }
+    // Symbols arrive sorted; drop aliases of the same address
+    functions_.erase(std::unique(functions_.begin(), functions_.end(),
+                                 [](const Function& a, const Function& b) { return a.lo == b.lo; }),
+                     functions_.end());
+    Function unknown;
+    unknown.name = "[unknown]";
+    unknown.lo = unknown.hi = 0;
+    functions_.push_back(unknown);
+    unknown_ = (int)functions_.size() - 1;
+    for (Function& f : functions_) {
+        memset(f.cycles, 0, sizeof(f.cycles));
+        f.instructions = 0;
+    }
+    memset(category_totals_, 0, sizeof(category_totals_));
+    last_ = unknown_;
+
+    StackNode root = {-1, unknown_, 0};
+    nodes_.push_back(root);
+    stack_.push_back(0);
+}
+
+int Profiler::lookup(uint32_t pc) {
+    // Straight-line code stays in one function for many cycles
+    const Function& prev = functions_[last_];
+    if (pc >= prev.lo && pc < prev.hi) return last_;
+    auto it = std::upper_bound(functions_.begin(), functions_.end() - 1, pc,
+                               [](uint32_t a, const Function& f) { return a < f.lo; });
+    if (it == functions_.begin()) return unknown_;
+    --it;
+    return pc < it->hi ? (int)(it - functions_.begin()) : unknown_;
+}
+
+int Profiler::child(int node, int function) {
+    auto key = std::make_pair(node, function);
+    auto it = children_.find(key);
+    if (it != children_.end()) return it->second;
+    StackNode n = {node, function, 0};
+    nodes_.push_back(n);
+    int id = (int)nodes_.size() - 1;
+    children_[key] = id;
+    return id;
+}
+
+// Update the shadow stack for the instruction just issued in `function`.
+// The frame change takes effect on the first instruction of the callee.
+void Profiler::track_call(uint32_t instr, int function) {
+    if (call_pending_) {
+        stack_.push_back(child(stack_.back(), function));
+    } else if (ret_pending_ && stack_.size() > 1) {
+        stack_.pop_back();
+    }
+    call_pending_ = ret_pending_ = false;
+    // Jumps between functions without a call (tail calls, traps) replace the frame
+    if (nodes_[stack_.back()].function != function) {
+        int parent = stack_.size() > 1 ? stack_[stack_.size() - 2] : 0;
+        stack_.back() = child(parent, function);
+    }
+
+    uint32_t opcode = instr & 0x7F;
+    uint32_t rd = (instr >> 7) & 0x1F;
+    uint32_t rs1 = (instr >> 15) & 0x1F;
+    bool link = rd == 1 || rd == 5;
+    if (opcode == 0x6F || opcode == 0x67) {
+        if (link) {
+            call_pending_ = true;
+        } else if (opcode == 0x67 && rd == 0 && (rs1 == 1 || rs1 == 5)) {
+            ret_pending_ = true;
+        }
+    }
+}
+
+void Profiler::sample(uint64_t cycle) {
+    (void)cycle;
+    uint32_t pc = TB_FC_CORE_SIG(top_, pc_id);
+    int f = lookup(pc);
+    last_ = f;
+
+    Category c;
+    if (TB_FC_CORE_SIG(top_, core_sleep_o)) {
+        c = SLEEP;
+    } else if (TB_FC_CORE_SIG(top_, instr_valid_id) && TB_FC_CORE_SIG(top_, id_valid)) {
+        c = EXEC;
+        functions_[f].instructions++;
+        track_call(TB_FC_CORE_SIG(top_, instr_rdata_id), f);
+    } else if (TB_FC_EVENT(top_, ld_stall)) {
+        c = LD_STALL;
+    } else if (TB_FC_EVENT(top_, jr_stall)) {
+        c = JR_STALL;
+    } else if (TB_FC_EVENT(top_, imiss)) {
+        c = IMISS;
+    } else if (TB_FC_EVENT(top_, pipe_stall)) {
+        c = PIPE_STALL;
+    } else {
+        c = OTHER;
+    }
+    functions_[f].cycles[c]++;
+    category_totals_[c]++;
+    nodes_[stack_.back()].cycles++;
+    total_++;
+}
+
+static uint64_t function_total(const uint64_t* cycles) {
+    uint64_t t = 0;
+    for (int i = 0; i < Profiler::NUM_CATEGORIES; i++) t += cycles[i];
+    return t;
+}
+
+// Functions that used any cycles, most expensive first
+std::vector<const Profiler::Function*> Profiler::by_cycles() const {
+    std::vector<const Function*> order;
+    for (const Function& f : functions_) {
+        if (function_total(f.cycles) > 0) order.push_back(&f);
+    }
+    std::stable_sort(order.begin(), order.end(), [](const Function* a, const Function* b) {
+        return function_total(a->cycles) > function_total(b->cycles);
+    });
+    return order;
+}
+
+void Profiler::write_flat(std::ostream& os) const {
+    std::vector<const Function*> order = by_cycles();
+
+    os << std::left << std::setw(32) << "function" << std::right
+       << std::setw(12) << "cycles" << std::setw(8) << "%";
+    for (int i = 0; i < NUM_CATEGORIES; i++) os << std::setw(10) << CATEGORY_NAMES[i];
+    os << std::setw(10) << "instrs" << std::setw(7) << "CPI" << "\n";
+    for (const Function* f : order) {
+        uint64_t t = function_total(f->cycles);
+        os << std::left << std::setw(32) << f->name << std::right
+           << std::setw(12) << t << std::setw(8) << tb_fixed(total_ ? 100.0 * t / total_ : 0.0, 2);
+        for (int i = 0; i < NUM_CATEGORIES; i++) os << std::setw(10) << f->cycles[i];
+        os << std::setw(10) << f->instructions << std::setw(7)
+           << tb_fixed(f->instructions ? (double)(t - f->cycles[SLEEP]) / f->instructions : 0.0, 2) << "\n";
+    }
+    os << std::left << std::setw(32) << "TOTAL" << std::right << std::setw(12) << total_
+       << std::setw(8) << "100.00";
+    for (int i = 0; i < NUM_CATEGORIES; i++) os << std::setw(10) << category_totals_[i];
+    os << "\n";
+}
+
+std::string Profiler::stack_path(int node) const {
+    std::vector<int> frames;
+    for (int n = node; n > 0; n = nodes_[n].parent) frames.push_back(nodes_[n].function);
+    std::string path;
+    for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+        if (!path.empty()) path += ';';
+        path += functions_[*it].name;
+    }
+    return path.empty() ? functions_[unknown_].name : path;
+}
+
+bool Profiler::write(const std::string& prefix) const {
+    std::ofstream flat(prefix + ".flat.txt");
+    if (!flat) return false;
+    write_flat(flat);
+
+    // Folded stacks, one "a;b;c <cycles>" line per stack (flamegraph.pl input)
+    std::ofstream folded(prefix + ".folded");
+    if (!folded) return false;
+    for (size_t n = 0; n < nodes_.size(); n++) {
+        if (nodes_[n].cycles == 0) continue;
+        folded << stack_path((int)n) << " " << nodes_[n].cycles << "\n";
+    }
+    return flat.good() && folded.good();
+}
+
+void Profiler::print_top(size_t n) const {
+    std::vector<const Function*> order = by_cycles();
+    tb_out() << "Profile (" << total_ << " cycles";
+    for (int i = 0; i < NUM_CATEGORIES; i++) {
+        if (category_totals_[i]) tb_out() << ", " << CATEGORY_NAMES[i] << " " << category_totals_[i];
+    }
+    tb_out() << "):" << std::endl;
+    for (size_t i = 0; i < order.size() && i < n; i++) {
+        uint64_t t = function_total(order[i]->cycles);
+        tb_out() << "  " << std::setw(6) << tb_fixed(total_ ? 100.0 * t / total_ : 0.0, 2) << "%  "
+                  << std::setw(10) << t << "  " << order[i]->name << std::endl;
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright 2025 Custom IP Integration
+// Cycle-attribution profiler for firmware running on the FC core.
+//
+// Every SoC cycle the profiler looks at the instruction in the cv32e40p ID
+// stage and charges the cycle to the ELF function containing its PC. The
+// cycle is classified from the core's own performance event strobes, so the
+// categories match what mhpmcounters would count:
+//   exec    an instruction left ID
+//   ld      load-use stall          (mhpmevent_ld_stall)
+//   jr      jump-register stall     (mhpmevent_jr_stall)
+//   imiss   instruction fetch stall (mhpmevent_imiss)
+//   pipe    pipeline/elw stall      (mhpmevent_pipe_stall)
+//   sleep   core clock-gated in wfi (core_sleep_o)
+//   other   anything else, mostly data memory wait
+// Calls and returns (jal/jalr through ra or t0) drive a shadow call stack, so
+// folded stacks for flame graphs come out alongside the flat profile.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "Vpulpissimo.h"
+#include "elf_loader.h"
+#include "sim_monitor.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class Profiler : public SimMonitor {
+public:
+    enum Category { EXEC, LD_STALL, JR_STALL, IMISS, PIPE_STALL, SLEEP, OTHER, NUM_CATEGORIES };
+
+    Profiler(Vpulpissimo* top, const ElfImage& elf);
+
+    void sample(uint64_t cycle) override;
+
+    uint64_t total_cycles() const { return total_; }
+
+    // Write <prefix>.flat.txt and <prefix>.folded. Returns false on I/O error.
+    bool write(const std::string& prefix) const;
+
+    // Print the `n` most expensive functions
+    void print_top(size_t n) const;
+
+private:
+    struct Function {
+        std::string name;
+        uint32_t lo, hi;
+        uint64_t cycles[NUM_CATEGORIES];
+        uint64_t instructions;
+    };
+
+    // Stacks are interned as a tree so the hot path only moves an index
+    struct StackNode {
+        int parent;
+        int function;
+        uint64_t cycles;
+    };
+
+    int lookup(uint32_t pc);
+    int child(int node, int function);
+    void track_call(uint32_t instr, int function);
+    std::vector<const Function*> by_cycles() const;
+    void write_flat(std::ostream& os) const;
+    std::string stack_path(int node) const;
+
+    Vpulpissimo* top_;
+    std::vector<Function> functions_; // Sorted by address, last entry is [unknown]
+    int unknown_;
+    int last_;                        // Function of the previous cycle
+
+    std::vector<StackNode> nodes_;
+    std::map<std::pair<int, int>, int> children_;
+    std::vector<int> stack_;          // Node ids, innermost last
+    bool call_pending_;
+    bool ret_pending_;
+
+    uint64_t total_;
+    uint64_t category_totals_[NUM_CATEGORIES];
+};
+
+#endif // PROFILER_H
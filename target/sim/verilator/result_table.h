@@ -0,0 +1,135 @@
+// Copyright 2025 Custom IP Integration
+// Benchmark results declared by firmware and read back at exit.
+//
+// Firmware reports any number of values without bus traffic or harness
+// changes (sw/bootcode/include/sim_results.h):
+//
+// - Every object symbol named sim_result_<name> of 4 or 8 bytes is one result
+//   called <name>.
+// - The array sim_results[] holds {const char* name; uint32_t value;}
+//   records, for names built at run time. It ends at a null name or at the
+//   symbol size.
+//
+// The symbols are looked up in the ELF when it is loaded; the values are
+// read through the L2 backdoor when the run ends. Record names are constant
+// strings and are read from the ELF file.
+
+#ifndef RESULT_TABLE_H
+#define RESULT_TABLE_H
+
+#include "elf_loader.h"
+#include "l2_backdoor.h"
+#include "tb_console.h"
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ResultTable {
+public:
+    static constexpr const char* PREFIX = "sim_result_";
+    static constexpr const char* TABLE = "sim_results";
+    static const uint32_t RECORD_SIZE = 8;
+    static const uint32_t MAX_NAME = 64;
+
+    ResultTable() : elf_(nullptr), table_addr_(0), table_records_(0) {}
+
+    // Find the result symbols; returns the number of named globals plus the
+    // capacity of the table
+    size_t locate(const ElfImage& elf) {
+        elf_ = &elf;
+        globals_.clear();
+        table_records_ = 0;
+        size_t prefix_len = std::string(PREFIX).size();
+        for (const ElfImage::Symbol& s : elf.symbols()) {
+            if (s.name.compare(0, prefix_len, PREFIX) == 0 && (s.size == 4 || s.size == 8)) {
+                globals_.push_back(s);
+            } else if (s.name == TABLE && s.size >= RECORD_SIZE) {
+                table_addr_ = s.addr;
+                table_records_ = s.size / RECORD_SIZE;
+            }
+        }
+        return globals_.size() + table_records_;
+    }
+
+    bool empty() const { return globals_.empty() && table_records_ == 0; }
+
+    // Read all values through the backdoor. Results outside L2 are skipped
+    // with a warning.
+    const std::vector<std::pair<std::string, uint64_t>>& read(const L2Backdoor& l2) {
+        values_.clear();
+        size_t prefix_len = std::string(PREFIX).size();
+        for (const ElfImage::Symbol& s : globals_) {
+            uint32_t lo = 0, hi = 0;
+            if (!l2.read_word(s.addr, lo) || (s.size == 8 && !l2.read_word(s.addr + 4, hi))) {
+                warn_outside(s.name, s.addr);
+                continue;
+            }
+            values_.emplace_back(s.name.substr(prefix_len), (uint64_t)hi << 32 | lo);
+        }
+        for (uint32_t i = 0; i < table_records_; i++) {
+            uint32_t addr = table_addr_ + i * RECORD_SIZE;
+            uint32_t name_ptr = 0, value = 0;
+            if (!l2.read_word(addr, name_ptr) || !l2.read_word(addr + 4, value)) {
+                warn_outside(TABLE, addr);
+                break;
+            }
+            if (name_ptr == 0) break;
+            std::string name = read_string(name_ptr, l2);
+            values_.emplace_back(name.empty() ? "record" + std::to_string(i) : name, value);
+        }
+        return values_;
+    }
+
+    const std::vector<std::pair<std::string, uint64_t>>& values() const { return values_; }
+
+    void print() const {
+        if (values_.empty()) return;
+        size_t width = 0;
+        for (const auto& v : values_) width = std::max(width, v.first.size());
+        tb_out() << "Benchmark results:" << std::endl;
+        for (const auto& v : values_) {
+            tb_out() << "  " << std::left << std::setw((int)width) << v.first << std::right
+                      << "  " << v.second << std::endl;
+        }
+    }
+
+private:
+    // Constant strings come from the ELF; a name built in RAM from L2
+    std::string read_string(uint32_t addr, const L2Backdoor& l2) const {
+        std::string s;
+        for (const ElfImage::Segment& seg : elf_->segments()) {
+            if (addr - seg.vaddr < seg.filesz) {
+                for (uint32_t i = addr - seg.vaddr; i < seg.filesz && s.size() < MAX_NAME && seg.data[i]; i++) {
+                    s += (char)seg.data[i];
+                }
+                if (seg.flags & 0x2) break;  // PF_W: may have changed, read the live copy
+                return s;
+            }
+        }
+        s.clear();
+        for (uint32_t a = addr; s.size() < MAX_NAME; a++) {
+            uint32_t word;
+            if (!l2.read_word(a & ~3u, word)) break;
+            char c = (char)(word >> (8 * (a & 3)));
+            if (!c) break;
+            s += c;
+        }
+        return s;
+    }
+
+    static void warn_outside(const std::string& name, uint32_t addr) {
+        tb_err() << "Warning: Result " << name << " at 0x" << std::hex << addr << std::dec
+                  << " is not in L2, not read" << std::endl;
+    }
+
+    const ElfImage* elf_;
+    std::vector<ElfImage::Symbol> globals_;
+    uint32_t table_addr_;
+    uint32_t table_records_;
+    std::vector<std::pair<std::string, uint64_t>> values_;
+};
+
+#endif // RESULT_TABLE_H
@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+"""
+Run many ELF binaries against one compiled Verilator model in parallel.
+
+Every (ELF, variant) pair is a job. Each job runs its own Vpulpissimo process
+in a private directory under the output directory, so traces and logs never
+collide. A variant is a named set of extra plusargs. Results are merged into
+results.json and results.csv in the output directory.
+
+A sweep runs every variant once per value of a plusarg, e.g. motor plant
+parameters; several sweeps multiply.
+
+Example:
+  run_regression.py -j 8 --timeout 600 \\
+      --variant default= --variant idle=+idle_skip \\
+      'sw/build/*.elf'
+  run_regression.py --plusargs '+motor_plant +motor_target=4096' \\
+      --sweep motor_load_nm=0,0.005,0.01 --sweep motor_j=2e-5,4e-5 motor_pid.elf
+"""
+import argparse
+import concurrent.futures
+import csv
+import glob
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+import threading
+import time
+
+# Lines printed by tb_main.cpp
+RESULT_PATTERNS = {
+    'result_cycles': re.compile(r'^RTL SIMULATION RESULT: (\d+) cycles'),
+    'exit_status': re.compile(r'^Program exited with status (\d+)'),
+    'total_cycles': re.compile(r'^Total Cycles: (\d+)'),
+    'sim_cycles_per_s': re.compile(r'^Simulated cycles per second: ([0-9.]+)'),
+}
+
+CSV_FIELDS = ['elf', 'variant', 'status', 'exit_code', 'exit_status', 'result_cycles',
+              'total_cycles', 'sim_cycles_per_s', 'peak_rss_kb', 'motor_settle_us',
+              'motor_overshoot', 'wall_s', 'job_dir']
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elfs', nargs='+',
+                        help='ELF files or glob patterns (quote globs), or @list files')
+    parser.add_argument('--model', default=None,
+                        help='Path to Vpulpissimo (default: build/verilator/obj_dir/Vpulpissimo)')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count() or 1,
+                        help='Parallel simulations (default: number of CPUs)')
+    parser.add_argument('--timeout', type=float, default=0,
+                        help='Per-job wall-clock timeout in seconds (0 = none)')
+    parser.add_argument('--variant', action='append', default=[], metavar='NAME=PLUSARGS',
+                        help='Named set of extra plusargs; may be repeated')
+    parser.add_argument('--sweep', action='append', default=[], metavar='PLUSARG=V1,V2,...',
+                        help='Run each variant with +PLUSARG=V for every value; may be repeated')
+    parser.add_argument('--plusargs', default='',
+                        help='Plusargs added to every job')
+    parser.add_argument('--out', default=None,
+                        help='Output directory (default: build/verilator/regression)')
+    parser.add_argument('--pin', action='store_true',
+                        help='Pin each job to one CPU with +cpu_affinity')
+    return parser.parse_args()
+
+
+def expand_elfs(patterns):
+    elfs = []
+    for pattern in patterns:
+        if pattern.startswith('@'):
+            with open(pattern[1:]) as f:
+                names = [l.strip() for l in f if l.strip() and not l.startswith('#')]
+        else:
+            names = sorted(glob.glob(pattern)) or [pattern]
+        for name in names:
+            path = os.path.abspath(name)
+            if not os.path.isfile(path):
+                print(f'Warning: {name} not found, skipping', file=sys.stderr)
+                continue
+            if path not in elfs:
+                elfs.append(path)
+    return elfs
+
+
+def parse_variants(specs):
+    variants = []
+    for spec in specs or ['default=']:
+        name, _, plusargs = spec.partition('=')
+        if not name:
+            sys.exit(f'Error: variant "{spec}" has no name')
+        variants.append((name, shlex.split(plusargs)))
+    return variants
+
+
+def expand_sweeps(variants, specs):
+    for spec in specs:
+        key, _, values = spec.partition('=')
+        key = key.lstrip('+')
+        if not key or not values:
+            sys.exit(f'Error: sweep "{spec}" needs PLUSARG=V1,V2,...')
+        variants = [(f'{name}-{key}-{value}', plusargs + [f'+{key}={value}'])
+                    for name, plusargs in variants for value in values.split(',')]
+    return variants
+
+
+def job_name(elf):
+    return os.path.splitext(os.path.basename(elf))[0]
+
+
+class CpuSlots:
+    """Hands out CPU ids to running jobs when --pin is used."""
+
+    def __init__(self, count):
+        self.free = list(range(count))
+        self.lock = threading.Lock()
+
+    def take(self):
+        with self.lock:
+            return self.free.pop(0)
+
+    def give(self, cpu):
+        with self.lock:
+            self.free.append(cpu)
+
+
+def run_job(model, elf, variant, plusargs, job_dir, timeout, slots):
+    os.makedirs(job_dir, exist_ok=True)
+    cmd = [model, f'+elf={elf}', '+report=report.json'] + plusargs
+    cpu = slots.take() if slots else None
+    if cpu is not None:
+        cmd.append(f'+cpu_affinity={cpu}')
+
+    result = {'elf': elf, 'variant': variant, 'job_dir': job_dir,
+              'exit_code': None, 'exit_status': None, 'result_cycles': None,
+              'total_cycles': None, 'sim_cycles_per_s': None, 'peak_rss_kb': None,
+              'motor_settle_us': None, 'motor_overshoot': None, 'results': {}}
+    start = time.monotonic()
+    with open(os.path.join(job_dir, 'run.log'), 'w') as log:
+        log.write(' '.join(shlex.quote(c) for c in cmd) + '\n')
+        log.flush()
+        try:
+            proc = subprocess.run(cmd, cwd=job_dir, stdout=log, stderr=subprocess.STDOUT,
+                                  timeout=timeout or None)
+            result['exit_code'] = proc.returncode
+            status = None
+        except subprocess.TimeoutExpired:
+            status = 'timeout'
+        except OSError as e:
+            log.write(f'Cannot start simulation: {e}\n')
+            status = 'error'
+    result['wall_s'] = round(time.monotonic() - start, 3)
+    if slots:
+        slots.give(cpu)
+
+    with open(os.path.join(job_dir, 'run.log')) as log:
+        for line in log:
+            for key, pattern in RESULT_PATTERNS.items():
+                m = pattern.match(line)
+                if m:
+                    value = m.group(1)
+                    result[key] = float(value) if '.' in value else int(value)
+    # The JSON report is authoritative where the model writes one
+    try:
+        with open(os.path.join(job_dir, 'report.json')) as f:
+            report = json.load(f)
+        result['exit_status'] = report.get('exit_status')
+        result['result_cycles'] = report.get('benchmark_cycles')
+        result['total_cycles'] = report.get('cycles')
+        result['peak_rss_kb'] = report.get('peak_rss_kb')
+        result['motor_settle_us'] = report.get('motor_settle_us')
+        result['motor_overshoot'] = report.get('motor_overshoot')
+        result['results'] = report.get('results') or {}
+        if report.get('sim_khz') is not None:
+            result['sim_cycles_per_s'] = report['sim_khz'] * 1e3
+    except (OSError, ValueError):
+        pass
+
+    if status is None:
+        if result['exit_code'] != 0:
+            status = 'fail'
+        elif result['result_cycles'] is not None or result['exit_status'] is not None:
+            status = 'pass'
+        else:
+            status = 'incomplete'
+    result['status'] = status
+    return result
+
+
+def main():
+    args = parse_args()
+    root = subprocess.run(['git', 'rev-parse', '--show-toplevel'], capture_output=True,
+                          text=True, cwd=os.path.dirname(os.path.abspath(__file__))).stdout.strip()
+    build_dir = os.path.join(root, 'build', 'verilator')
+    model = os.path.abspath(args.model or os.path.join(build_dir, 'obj_dir', 'Vpulpissimo'))
+    out_dir = os.path.abspath(args.out or os.path.join(build_dir, 'regression'))
+    if not os.access(model, os.X_OK):
+        sys.exit(f'Error: model {model} not found, run "make build" first')
+
+    elfs = expand_elfs(args.elfs)
+    if not elfs:
+        sys.exit('Error: no ELF files to run')
+    variants = expand_sweeps(parse_variants(args.variant), args.sweep)
+    common = shlex.split(args.plusargs)
+
+    jobs = max(1, args.jobs)
+    cpus = os.cpu_count() or 1
+    slots = None
+    if args.pin:
+        if jobs > cpus:
+            print(f'Warning: {jobs} jobs exceed {cpus} CPUs, not pinning', file=sys.stderr)
+        else:
+            slots = CpuSlots(jobs)
+
+    names = [job_name(e) for e in elfs]
+    print(f'Running {len(elfs)} ELF(s) x {len(variants)} variant(s) on {jobs} worker(s)')
+    results = []
+    with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+        futures = []
+        for elf, name in zip(elfs, names):
+            # Disambiguate ELFs with the same file name from different directories
+            if names.count(name) > 1:
+                name = f'{name}_{elfs.index(elf)}'
+            for variant, plusargs in variants:
+                job_dir = os.path.join(out_dir, name, variant)
+                futures.append(pool.submit(run_job, model, elf, variant, common + plusargs,
+                                           job_dir, args.timeout, slots))
+        for future in concurrent.futures.as_completed(futures):
+            r = future.result()
+            results.append(r)
+            cycles = r['result_cycles'] if r['result_cycles'] is not None else '-'
+            print(f'  [{len(results)}/{len(futures)}] {r["status"]:10s} {job_name(r["elf"])} '
+                  f'({r["variant"]}) cycles={cycles} wall={r["wall_s"]}s')
+
+    results.sort(key=lambda r: (r['elf'], r['variant']))
+    os.makedirs(out_dir, exist_ok=True)
+    with open(os.path.join(out_dir, 'results.json'), 'w') as f:
+        json.dump(results, f, indent=2)
+    # Firmware results (sim_result_* symbols) become one column each
+    names = sorted({name for r in results for name in r['results']})
+    with open(os.path.join(out_dir, 'results.csv'), 'w', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=CSV_FIELDS + [f'result.{n}' for n in names],
+                                extrasaction='ignore')
+        writer.writeheader()
+        for r in results:
+            writer.writerow(dict(r, **{f'result.{n}': v for n, v in r['results'].items()}))
+
+    passed = sum(1 for r in results if r['status'] == 'pass')
+    print(f'{passed}/{len(results)} passed, results in {out_dir}/results.{{json,csv}}')
+    return 0 if passed == len(results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,120 @@
+// Copyright 2025 Custom IP Integration
+// Machine-readable summary of one simulation run.
+//
+// The harness fills in a RunReport as it goes and writes it as a single JSON
+// object at exit (+report=<file>), so simulator throughput and benchmark
+// results can be tracked across runs without scraping the console log.
+// Numbers that were not measured (no result marker, no exit) are null.
+
+#ifndef RUN_REPORT_H
+#define RUN_REPORT_H
+
+#include <sys/resource.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class RunReport {
+public:
+    // Fields in output order; values are stored already encoded as JSON
+    void set(const std::string& key, const std::string& value) { put(key, quote(value)); }
+    void set(const std::string& key, const char* value) { put(key, quote(value)); }
+    void set(const std::string& key, bool value) { put(key, value ? "true" : "false"); }
+    void set(const std::string& key, uint64_t value) { put(key, std::to_string(value)); }
+    void set(const std::string& key, int value) { put(key, std::to_string(value)); }
+    void set(const std::string& key, unsigned value) { put(key, std::to_string(value)); }
+    void set(const std::string& key, double value) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.6g", value);
+        put(key, buf);
+    }
+    void set_null(const std::string& key) { put(key, "null"); }
+    // Named counts as a nested object
+    void set(const std::string& key, const std::vector<std::pair<std::string, uint64_t>>& values) {
+        std::string json = "{";
+        for (size_t i = 0; i < values.size(); i++) {
+            json += (i ? ", " : "") + quote(values[i].first) + ": " + std::to_string(values[i].second);
+        }
+        put(key, json + "}");
+    }
+
+    // Peak resident set size of this process in KiB, 0 if unknown
+    static uint64_t peak_rss_kb() {
+        struct rusage ru;
+        if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#ifdef __APPLE__
+        return (uint64_t)ru.ru_maxrss / 1024; // Bytes on macOS
+#else
+        return (uint64_t)ru.ru_maxrss;
+#endif
+    }
+
+    // Read a numeric field back from a report written by another run, e.g. a
+    // baseline model. Returns false if the file or a numeric field is missing.
+    static bool read_number(const std::string& path, const std::string& key, double& value) {
+        std::ifstream is(path);
+        if (!is) return false;
+        std::stringstream ss;
+        ss << is.rdbuf();
+        std::string text = ss.str();
+        size_t pos = text.find(quote(key) + ":");
+        if (pos == std::string::npos) return false;
+        const char* start = text.c_str() + pos + key.size() + 3;
+        char* end = nullptr;
+        value = strtod(start, &end);
+        return end != start;
+    }
+
+    bool write(const std::string& path) const {
+        std::ofstream os(path);
+        if (!os) return false;
+        os << "{\n";
+        for (size_t i = 0; i < fields_.size(); i++) {
+            os << "  " << quote(fields_[i].first) << ": " << fields_[i].second
+               << (i + 1 < fields_.size() ? ",\n" : "\n");
+        }
+        os << "}\n";
+        return os.good();
+    }
+
+private:
+    void put(const std::string& key, const std::string& json) {
+        for (auto& f : fields_) {
+            if (f.first == key) {
+                f.second = json;
+                return;
+            }
+        }
+        fields_.emplace_back(key, json);
+    }
+
+    static std::string quote(const std::string& s) {
+        std::string out = "\"";
+        for (char c : s) {
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+            }
+        }
+        return out + "\"";
+    }
+
+    std::vector<std::pair<std::string, std::string>> fields_;
+};
+
+#endif // RUN_REPORT_H
@@ -0,0 +1,22 @@
+// Copyright 2025 Custom IP Integration
+// Common interface for passive monitors attached to the Verilator harness.
+
+#ifndef SIM_MONITOR_H
+#define SIM_MONITOR_H
+
+#include <cstdint>
+
+// A monitor only observes the model. sample() is called once per SoC clock
+// cycle, right before the rising edge is evaluated, so the signals it reads
+// are the ones the design registers on that edge.
+class SimMonitor {
+public:
+    virtual ~SimMonitor() {}
+
+    virtual void sample(uint64_t cycle) = 0;
+
+    // Return true to end the simulation after the current cycle
+    virtual bool stop_requested() const { return false; }
+};
+
+#endif // SIM_MONITOR_H
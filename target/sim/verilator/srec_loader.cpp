@@ -0,0 +1,112 @@
+// Copyright 2025 Custom IP Integration
+// Streaming Motorola S-record decoder for the Verilator harness.
+
+#include "srec_loader.h"
+#include "tb_console.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+// Hex digit values, -1 for non-hex characters
+struct HexTable {
+    int8_t v[256];
+    HexTable() {
+        for (int i = 0; i < 256; i++) v[i] = -1;
+        for (int i = 0; i < 10; i++) v['0' + i] = i;
+        for (int i = 0; i < 6; i++) {
+            v['a' + i] = 10 + i;
+            v['A' + i] = 10 + i;
+        }
+    }
+};
+const HexTable hex;
+
+// Address field width in bytes for S0..S9
+const int SREC_ADDR_BYTES[10] = {2, 2, 3, 4, 0, 2, 3, 4, 3, 2};
+
+} // namespace
+
+bool load_srec(const std::string& filename, MemoryImage& image, uint32_t& entry_point, SrecStats& stats) {
+    stats.records = 0;
+    stats.bad_records = 0;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        tb_err() << "Error: Cannot open SREC file: " << filename << std::endl;
+        return false;
+    }
+    std::vector<char> buf((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(buf.data());
+    const unsigned char* end = p + buf.size();
+    size_t line = 0;
+    uint8_t rec[256];
+
+    while (p < end) {
+        // Find the start of the next record
+        const unsigned char* eol = p;
+        while (eol < end && *eol != '\n') eol++;
+        line++;
+        const unsigned char* q = p;
+        p = eol + 1;
+        while (q < eol && (*q == ' ' || *q == '\t')) q++;
+        if (eol - q < 4 || *q != 'S' || q[1] < '0' || q[1] > '9') continue;
+
+        int type = q[1] - '0';
+        q += 2;
+
+        // Decode count + address + data + checksum in one pass
+        int hi = hex.v[q[0]], lo = hex.v[q[1]];
+        if (hi < 0 || lo < 0) {
+            stats.bad_records++;
+            continue;
+        }
+        int count = (hi << 4) | lo;
+        q += 2;
+        if (eol - q < count * 2 || count < SREC_ADDR_BYTES[type] + 1) {
+            tb_err() << "Warning: " << filename << ":" << line << ": truncated S" << type << " record" << std::endl;
+            stats.bad_records++;
+            continue;
+        }
+        unsigned sum = count;
+        bool bad_hex = false;
+        for (int i = 0; i < count; i++) {
+            hi = hex.v[q[2 * i]];
+            lo = hex.v[q[2 * i + 1]];
+            bad_hex |= (hi < 0) | (lo < 0);
+            rec[i] = (uint8_t)((hi << 4) | lo);
+            sum += rec[i];
+        }
+        if (bad_hex || (sum & 0xFF) != 0xFF) {
+            tb_err() << "Warning: " << filename << ":" << line << ": "
+                      << (bad_hex ? "malformed" : "checksum error in") << " S" << type << " record" << std::endl;
+            stats.bad_records++;
+            continue;
+        }
+
+        int addr_bytes = SREC_ADDR_BYTES[type];
+        uint32_t addr = 0;
+        for (int i = 0; i < addr_bytes; i++) addr = (addr << 8) | rec[i];
+        int data_len = count - addr_bytes - 1;
+
+        switch (type) {
+        case 1:
+        case 2:
+        case 3:
+            image.write(addr, rec + addr_bytes, data_len);
+            stats.records++;
+            break;
+        case 7:
+        case 8:
+        case 9:
+            entry_point = addr;
+            break;
+        default:
+            break; // Header and count records
+        }
+    }
+    return true;
+}
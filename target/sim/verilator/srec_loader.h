@@ -0,0 +1,22 @@
+// Copyright 2025 Custom IP Integration
+// Streaming Motorola S-record decoder for the Verilator harness.
+
+#ifndef SREC_LOADER_H
+#define SREC_LOADER_H
+
+#include "memory_image.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+struct SrecStats {
+    size_t records;      // Data records decoded
+    size_t bad_records;  // Records skipped for malformed hex or bad checksum
+};
+
+// Decode `filename` straight into `image`. The entry point is taken from the
+// S7/S8/S9 termination record if present. Returns false if the file cannot
+// be read.
+bool load_srec(const std::string& filename, MemoryImage& image, uint32_t& entry_point, SrecStats& stats);
+
+#endif // SREC_LOADER_H
@@ -0,0 +1,38 @@
+// Copyright 2025 Custom IP Integration
+// Console streams of the harness.
+//
+// tb_out() and tb_err() stand in for std::cout and std::cerr. Every thread
+// has its own stream objects, so the formatting state one simulation
+// instance sets (std::fixed, precision, fill) never reaches another one
+// running in the same process, and a thread can send its console to a log
+// (+instances=) without touching the process-wide streams. By default they
+// write to the buffers of std::cout and std::cerr.
+
+#ifndef TB_CONSOLE_H
+#define TB_CONSOLE_H
+
+#include <iostream>
+#include <ostream>
+#include <streambuf>
+
+inline std::ostream& tb_out() {
+    static thread_local std::ostream os(std::cout.rdbuf());
+    return os;
+}
+
+// Unit-buffered and tied to tb_out(), like std::cerr
+inline std::ostream& tb_err() {
+    static thread_local std::ostream os(std::cerr.rdbuf());
+    static thread_local bool init = (os.setf(std::ios::unitbuf), os.tie(&tb_out()), true);
+    (void)init;
+    return os;
+}
+
+// Send the calling thread's console to `log`, nullptr for stdout/stderr again
+inline void tb_console_redirect(std::streambuf* log) {
+    tb_out().flush();
+    tb_out().rdbuf(log ? log : std::cout.rdbuf());
+    tb_err().rdbuf(log ? log : std::cerr.rdbuf());
+}
+
+#endif // TB_CONSOLE_H
@@ -0,0 +1,21 @@
+// Copyright 2025 Custom IP Integration
+// Number formatting for harness output.
+//
+// tb_fixed() formats a value with a fixed number of decimals in a stream of
+// its own, so the precision and float format of the console or report stream
+// it ends up in are left as they were.
+
+#ifndef TB_FORMAT_H
+#define TB_FORMAT_H
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+inline std::string tb_fixed(double value, int decimals) {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(decimals) << value;
+    return os.str();
+}
+
+#endif // TB_FORMAT_H
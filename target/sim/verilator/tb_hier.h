@@ -0,0 +1,95 @@
+// Copyright 2025 Custom IP Integration
+// Flattened hierarchy handles into the Verilated pulpissimo model.
+//
+// All internal signals the harness touches are reached through the names
+// Verilator generates with --public-flat-rw. They are collected here so that a
+// Verilator version bump or an RTL hierarchy change only needs fixing in one
+// place.
+
+#ifndef TB_HIER_H
+#define TB_HIER_H
+
+// Verilator >= 4.210 moved internal signals from the top class into
+// top->rootp. Build with -CFLAGS "-DTB_ROOT(t)=((t)->rootp)" for those
+// versions.
+#ifndef TB_ROOT
+#define TB_ROOT(top) (top)
+#endif
+
+// Top-level ports. The FLL build is clocked from pad_ref_clk; a build with
+// +define+EXTERNAL_CLOCK exposes the slow, SoC and peripheral clocks instead.
+#define TB_PORT_REF_CLK(top)  ((top)->pad_ref_clk)
+#define TB_PORT_SLOW_CLK(top) ((top)->ext_slow_clk_i)
+#define TB_PORT_SOC_CLK(top)  ((top)->ext_soc_clk_i)
+#define TB_PORT_PER_CLK(top)  ((top)->ext_per_clk_i)
+#define TB_PORT_JTAG_TCK(top) ((top)->pad_jtag_tck)
+#define TB_PORT_JTAG_TMS(top) ((top)->pad_jtag_tms)
+#define TB_PORT_JTAG_TDI(top) ((top)->pad_jtag_tdi)
+#define TB_PORT_JTAG_TRSTN(top) ((top)->pad_jtag_trstn)
+#define TB_PORT_JTAG_TDO(top) ((top)->pad_jtag_tdo)
+#define TB_PORT_PAD_IO(top)   ((top)->pad_io)
+
+// custom_actuator_ctrl signals, exported as top-level ports by pulpissimo.sv
+// with +define+ACTUATOR_PORTS (build with VERILATOR_ACTUATOR=1, which also
+// defines TB_ACTUATOR_PORTS)
+#define TB_PORT_ACTUATOR_PWM(top)      ((top)->actuator_pwm_o)
+#define TB_PORT_ACTUATOR_DIR(top)      ((top)->actuator_dir_o)
+#define TB_PORT_ACTUATOR_ENABLE(top)   ((top)->actuator_enable_o)
+#define TB_PORT_ACTUATOR_FEEDBACK(top) ((top)->sensor_feedback_i)
+// interrupt_o; not routed to the FC interrupt controller
+#define TB_PORT_ACTUATOR_IRQ(top)      ((top)->actuator_irq_o)
+
+// Plain signals and arrays
+#define TB_SIG(top, path) (TB_ROOT(top)->pulpissimo__DOT__##path)
+// Interface and cell instances
+#define TB_CELL(top, path) (TB_ROOT(top)->__PVT__pulpissimo__DOT__##path)
+
+// SoC interconnect master ports (XBAR_TCDM_BUS)
+#define TB_DEBUG_BUS(top) \
+    TB_CELL(top, i_soc_domain__DOT__i_pulp_soc__DOT__s_lint_debug_bus)
+#define TB_FC_DATA_BUS(top) \
+    TB_CELL(top, i_soc_domain__DOT__i_pulp_soc__DOT__s_lint_fc_data_bus)
+#define TB_FC_INSTR_BUS(top) \
+    TB_CELL(top, i_soc_domain__DOT__i_pulp_soc__DOT__s_lint_fc_instr_bus)
+#define TB_UDMA_RX_BUS(top) \
+    TB_CELL(top, i_soc_domain__DOT__i_pulp_soc__DOT__s_lint_udma_rx_bus)
+#define TB_UDMA_TX_BUS(top) \
+    TB_CELL(top, i_soc_domain__DOT__i_pulp_soc__DOT__s_lint_udma_tx_bus)
+
+// Fabric controller core (cv32e40p)
+#define TB_FC_CORE_SIG(top, sig) \
+    TB_SIG(top, i_soc_domain__DOT__i_pulp_soc__DOT__fc_subsystem_i__DOT__FC_CORE__DOT__lFC_CORE__DOT__##sig)
+
+// Performance event strobes of the FC core (hpm_events of cv32e40p_cs_registers)
+#define TB_FC_EVENT(top, name) TB_FC_CORE_SIG(top, mhpmevent_##name)
+// Performance counter registers (mcycle = [0], minstret = [2])
+#define TB_FC_CSR_SIG(top, sig) TB_FC_CORE_SIG(top, cs_registers_i__DOT__##sig)
+
+// uDMA UART 0 TX before the pad mux (uart_pkg::uart_to_pad_t.tx_o)
+#define TB_UART_TX(top) (TB_SIG(top, s_uart_to_pad) & 1)
+
+// FC timer (apb_timer_unit): configuration, compare and counter registers of
+// the low and high 32-bit counters
+#define TB_TIMER_SIG(top, sig) \
+    TB_SIG(top, i_soc_domain__DOT__i_pulp_soc__DOT__soc_peripherals_i__DOT__i_apb_timer_unit__DOT__##sig)
+
+// uDMA subsystem: per-channel enables of the linear RX/TX channels
+// (udma_ch_addrgen cfg_en_o), high from the start of a transfer until its last
+// beat and for as long as a continuous transfer is configured
+#define TB_UDMA_SIG(top, sig) \
+    TB_SIG(top, i_soc_domain__DOT__i_pulp_soc__DOT__soc_peripherals_i__DOT__i_udma__DOT__##sig)
+
+// Advanced timer (apb_adv_timer): per-timer clock enables of the APB interface
+#define TB_ADV_TIMER_SIG(top, sig) \
+    TB_SIG(top, i_soc_domain__DOT__i_pulp_soc__DOT__soc_peripherals_i__DOT__i_apb_adv_timer__DOT__##sig)
+
+// L2 memory (l2_ram_multi_bank): word-interleaved banks and the two private
+// banks. Each bank is a tc_sram whose `sram` array holds 32-bit words.
+#define TB_L2_INTL_BANK(top, i) \
+    TB_SIG(top, i_soc_domain__DOT__i_pulp_soc__DOT__l2_ram_i__DOT__CUTS__BRA__##i##__KET____DOT__bank_i__DOT__sram)
+#define TB_L2_PRI0_BANK(top) \
+    TB_SIG(top, i_soc_domain__DOT__i_pulp_soc__DOT__l2_ram_i__DOT__bank_sram_pri0_i__DOT__sram)
+#define TB_L2_PRI1_BANK(top) \
+    TB_SIG(top, i_soc_domain__DOT__i_pulp_soc__DOT__l2_ram_i__DOT__bank_sram_pri1_i__DOT__sram)
+
+#endif // TB_HIER_H
@@ -1,26 +1,44 @@
 #include "Vpulpissimo.h"
 #include "Vpulpissimo_XBAR_TCDM_BUS.h"
 #include "verilated.h"
-#ifdef TRACE_VCD
-#include "verilated_vcd_c.h"
+#ifdef TB_SAVABLE
+#include "verilated_save.h"
 #endif
+#include "l2_backdoor.h"
+#include "bus_snooper.h"
+#include "tb_format.h"
+#include "elf_loader.h"
+#include "srec_loader.h"
+#include "clock_scheduler.h"
+#include "idle_skip.h"
+#include "trace_window.h"
+#include "profiler.h"
+#include "contention_profiler.h"
+#include "latency_monitor.h"
+#include "perf_counters.h"
+#include "uart_model.h"
+#include "run_report.h"
+#include "iss.h"
+#include "debug_bus_transactor.h"
+#include "dmi_server.h"
+#include "jtag_dtm.h"
+#include "gdb_server.h"
+#include "motor_plant.h"
+#include "result_table.h"
+#include "instance_pool.h"
+#include "tb_console.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
-#include <map>
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 #include <iomanip>
-
-// SREC record types
-#define SREC_HEADER 0
-#define SREC_DATA_16BIT 1
-#define SREC_DATA_24BIT 2
-#define SREC_DATA_32BIT 3
-#define SREC_COUNT_16BIT 5
-#define SREC_COUNT_24BIT 6
-#define SREC_START_32BIT 9
+#include <chrono>
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 // Result memory location (virtual stdout)
 #define RESULT_BASE_ADDR 0x1A10F000
@@ -28,122 +46,127 @@
 #define RESULT_COMPLETE_ADDR (RESULT_BASE_ADDR + 0x04)
 #define RESULT_MARKER 0xDEADBEEF
 
+// libc exit() writes status | EXIT_FLAG here (EXIT_REG_ADDR in the bootcode)
+#define EXIT_REG_ADDR 0x1A1040A0
+#define EXIT_FLAG 0x80000000u
+
 // Memory regions
 #define L2_START_ADDR 0x1C000000
 #define L2_END_ADDR   0x1C090000
 #define ROM_START_ADDR 0x1A000000
 #define ROM_END_ADDR   0x1A040000
 
-struct SRECRecord {
-    int type;
-    uint32_t address;
-    std::vector<uint8_t> data;
-    uint32_t entry_point;
-};
+// Debug bus loads give up after this many cycles without a grant or response
+#define DEBUG_BUS_MAX_STALL 5000
 
-// Parse SREC file and extract entry point
-std::vector<SRECRecord> parse_srec(const std::string& filename, uint32_t& entry_point) {
-    std::vector<SRECRecord> records;
-    std::ifstream file(filename);
-    std::string line;
-    entry_point = 0x1A000000; // Default entry point
-    
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open SREC file: " << filename << std::endl;
-        return records;
-    }
-    
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] != 'S') continue;
-        
-        SRECRecord rec;
-        rec.type = line[1] - '0';
-        
-        if (rec.type == SREC_HEADER) {
-            continue;
-        }
-        
-        if (rec.type == SREC_START_32BIT) {
-            // S9 record contains entry point
-            int length = std::stoi(line.substr(2, 2), nullptr, 16);
-            if (length >= 5) {
-                entry_point = std::stoul(line.substr(4, 8), nullptr, 16);
-            }
-            continue;
-        }
-        
-        if (rec.type == SREC_DATA_32BIT) {
-            // Parse S3 record: S3<length><address><data><checksum>
-            int length = std::stoi(line.substr(2, 2), nullptr, 16);
-            int addr_len = 8; // 32-bit address = 4 bytes = 8 hex chars
-            rec.address = std::stoul(line.substr(4, addr_len), nullptr, 16);
-            
-            int data_len = (length - 5) * 2; // length includes addr(4) + checksum(1)
-            for (int i = 0; i < data_len; i += 2) {
-                uint8_t byte = std::stoul(line.substr(4 + addr_len + i, 2), nullptr, 16);
-                rec.data.push_back(byte);
-            }
-            
-            records.push_back(rec);
-        }
-    }
-    
-    return records;
+#ifdef TB_SAVABLE
+// Checkpoints hold the Verilated model state followed by the clock
+// scheduler state. Verilator itself rejects files saved from a different model.
+#define CHECKPOINT_MAGIC 0x50554C50434B5054ULL // "PULPCKPT"
+
+bool save_model(Vpulpissimo* top, ClockScheduler& sched, const std::string& filename) {
+    VerilatedSave os;
+    os.open(filename.c_str());
+    if (!os.isOpen()) return false;
+    uint64_t magic = CHECKPOINT_MAGIC;
+    os.write(&magic, sizeof(magic));
+    os << *top;
+    sched.save(os);
+    os.close();
+    return true;
 }
 
-// Simple clock generator
-class ClockGen {
-public:
-    ClockGen() : clk_(false), cycle_(0) {}
-    
-    bool tick() {
-        clk_ = !clk_;
-        if (!clk_) cycle_++;
-        return clk_;
+bool restore_model(Vpulpissimo* top, ClockScheduler& sched, const std::string& filename) {
+    VerilatedRestore is;
+    is.open(filename.c_str());
+    if (!is.isOpen()) return false;
+    uint64_t magic = 0;
+    is.read(&magic, sizeof(magic));
+    if (magic != CHECKPOINT_MAGIC) {
+        tb_err() << "Error: " << filename << " is not a pulpissimo checkpoint" << std::endl;
+        return false;
     }
-    
-    uint64_t get_cycle() const { return cycle_; }
-    bool get_clk() const { return clk_; }
-    
-private:
-    bool clk_;
-    uint64_t cycle_;
-};
+    is >> *top;
+    if (!sched.restore(is)) {
+        tb_err() << "Error: " << filename << " was saved with a different clock setup" << std::endl;
+        return false;
+    }
+    is.close();
+    return true;
+}
+#endif
 
 // Memory accessor using debug bus OR direct memory access
 class MemoryAccessor {
 public:
-    MemoryAccessor(Vpulpissimo* top) : top_(top), debug_bus_(nullptr) {
+    MemoryAccessor(Vpulpissimo* top) : top_(top), debug_bus_(nullptr), backdoor_(top), block_bytes_(0) {
         // Try to access debug bus through Verilator model's internal structure
         // With --public-flat-rw flag, Verilator exposes internal signals
-        debug_bus_ = top->__PVT__pulpissimo__DOT__i_soc_domain__DOT__i_pulp_soc__DOT__s_lint_debug_bus;
+        debug_bus_ = TB_DEBUG_BUS(top);
         
         if (debug_bus_ == nullptr) {
-            std::cerr << "Warning: Debug bus pointer is null." << std::endl;
-            std::cerr << "  Verilator needs --public-flat-rw flag to expose internal signals." << std::endl;
-            std::cerr << "  Memory loading through debug bus will not work." << std::endl;
-            std::cerr << "  Alternative: Use JTAG boot mode or direct memory initialization." << std::endl;
+            tb_err() << "Warning: Debug bus pointer is null." << std::endl;
+            tb_err() << "  Verilator needs --public-flat-rw flag to expose internal signals." << std::endl;
+            tb_err() << "  Memory loading through debug bus will not work." << std::endl;
+            tb_err() << "  Alternative: Use JTAG boot mode or direct memory initialization." << std::endl;
         } else {
-            std::cout << "Debug bus accessible - memory loading enabled" << std::endl;
+            tb_out() << "Debug bus accessible - memory loading enabled" << std::endl;
         }
     }
     
-    // Store memory writes
-    void write_memory(uint32_t addr, uint8_t data) {
-        writes_[addr] = data;
+    // Queue a contiguous block (an ELF segment or a run of the SREC image).
+    // `data` is not copied and must stay valid until the memory is loaded;
+    // nullptr means zero-fill.
+    void write_block(uint32_t addr, const uint8_t* data, uint32_t len) {
+        if (len == 0) return;
+        Block b = {addr, data, len};
+        blocks_.push_back(b);
+        block_bytes_ += len;
+    }
+    
+    // Load memory straight into the L2 SRAM arrays. No clock cycles are
+    // simulated, so this can run at any point after model construction.
+    bool preload_memory() {
+        if (get_write_count() == 0) {
+            return false;
+        }
+        
+        tb_out() << "Preloading " << get_write_count() << " bytes into L2 via backdoor..." << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        
+        size_t bytes_written = 0;
+        size_t bytes_failed = 0;
+        
+        // Blocks are placed with one contiguous copy each
+        for (const Block& b : blocks_) {
+            size_t n = backdoor_.write_block(b.addr, b.data, b.len);
+            bytes_written += n;
+            if (n != b.len) {
+                bytes_failed += b.len - n;
+                tb_err() << "Warning: Block at 0x" << std::hex << b.addr
+                          << " is partly outside L2 memory range, skipping" << std::dec << std::endl;
+            }
+        }
+        
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        tb_out() << "Memory preload complete: " << bytes_written << " bytes written, "
+                  << bytes_failed << " failed (" << elapsed << " us)" << std::endl;
+        
+        return bytes_written > 0;
     }
     
     // Load memory through debug bus with improved initialization
     // NOTE: Debug bus is clocked by SoC clock (interconnect clock), not reference clock
     // The SoC clock is generated from reference clock via FLL, so we need to wait
     // for the system to stabilize before accessing the debug bus
-    bool load_memory(ClockGen& clk_gen, uint64_t& time_ps, const uint64_t REF_CLK_PERIOD_PS) {
-        if (writes_.empty() || !debug_bus_) {
+    bool load_memory(ClockScheduler& sched) {
+        if (get_write_count() == 0 || !debug_bus_) {
             return false;
         }
         
-        std::cout << "Loading " << writes_.size() << " bytes into memory via debug bus..." << std::endl;
-        std::cout << "  NOTE: Debug bus uses SoC clock domain (not reference clock)" << std::endl;
+        tb_out() << "Loading " << get_write_count() << " bytes into memory via debug bus..." << std::endl;
+        tb_out() << "  NOTE: Debug bus uses SoC clock domain (not reference clock)" << std::endl;
         
         // Initialize debug bus - ensure it's in a known state
         debug_bus_->req = 0;
@@ -156,365 +179,869 @@ public:
         // because SoC clock is much faster than reference clock
         // SoC clock is typically 50-100 MHz, reference is 32 kHz
         // So 1 reference clock cycle = ~1500-3000 SoC clock cycles
-        std::cout << "  Waiting for SoC clock domain to stabilize..." << std::endl;
+        tb_out() << "  Waiting for SoC clock domain to stabilize..." << std::endl;
         for (int i = 0; i < 100; i++) {
-            bool clk = clk_gen.tick();
-            time_ps += REF_CLK_PERIOD_PS / 2;
-            top_->eval();
+            step(sched);
         }
         
-        // Group writes by 32-bit word addresses
-        std::map<uint32_t, uint32_t> word_writes;
-        for (const auto& w : writes_) {
-            uint32_t word_addr = w.first & ~0x3; // Align to word boundary
-            uint32_t byte_offset = w.first & 0x3;
-            
-            if (word_writes.find(word_addr) == word_writes.end()) {
-                word_writes[word_addr] = 0;
+        // Split blocks into word writes; partial words at block edges use byte enables
+        struct WordWrite {
+            uint32_t addr;
+            uint32_t data;
+            uint8_t be;
+        };
+        std::vector<WordWrite> word_writes;
+        word_writes.reserve(get_write_count() / 4 + 2 * blocks_.size());
+        for (const Block& b : blocks_) {
+            for (uint32_t i = 0; i < b.len; i++) {
+                uint32_t addr = b.addr + i;
+                if (word_writes.empty() || word_writes.back().addr != (addr & ~0x3u)) {
+                    WordWrite w = {addr & ~0x3u, 0, 0};
+                    word_writes.push_back(w);
+                }
+                uint32_t byte_offset = addr & 0x3;
+                word_writes.back().data |= (uint32_t)(b.data ? b.data[i] : 0) << (byte_offset * 8);
+                word_writes.back().be |= 1 << byte_offset;
             }
-            word_writes[word_addr] |= (w.second << (byte_offset * 8));
         }
         
-        std::cout << "Writing " << word_writes.size() << " words to L2 memory..." << std::endl;
-        
-        uint32_t words_written = 0;
+        // Queue everything; consecutive words go out back to back
         uint32_t words_failed = 0;
-        
-        for (const auto& w : word_writes) {
-            uint32_t addr = w.first;
-            uint32_t data = w.second;
-            
-            // Ensure we're writing to L2 memory range
-            if (addr < L2_START_ADDR || addr >= L2_END_ADDR) {
-                std::cerr << "Warning: Address 0x" << std::hex << addr 
+        for (const WordWrite& w : word_writes) {
+            if (w.addr < L2_START_ADDR || w.addr >= L2_END_ADDR) {
+                tb_err() << "Warning: Address 0x" << std::hex << w.addr
                           << " is outside L2 memory range, skipping" << std::dec << std::endl;
                 words_failed++;
                 continue;
             }
-            
-            // Set up write transaction
-            debug_bus_->req = 1;
-            debug_bus_->wen = 0; // 0 = write
-            debug_bus_->add = addr;
-            debug_bus_->wdata = data;
-            debug_bus_->be = 0xF; // All bytes enabled
-            
-            // Clock until grant - try longer timeout
-            int wait_cycles = 0;
-            const int MAX_WAIT_CYCLES = 5000; // Increased significantly
-            bool got_grant = false;
-            
-            while (wait_cycles < MAX_WAIT_CYCLES && !debug_bus_->gnt) {
-                bool clk = clk_gen.tick();
-                time_ps += REF_CLK_PERIOD_PS / 2;
-                top_->eval();
-                if (!clk) wait_cycles++;
-            }
-            
-            if (debug_bus_->gnt) {
-                got_grant = true;
-                
-                // Wait for valid response
-                wait_cycles = 0;
-                while (wait_cycles < 200 && !debug_bus_->r_valid) {
-                    bool clk = clk_gen.tick();
-                    time_ps += REF_CLK_PERIOD_PS / 2;
-                    top_->eval();
-                    if (!clk) wait_cycles++;
-                }
-                
-                if (debug_bus_->r_valid) {
-                    words_written++;
-                } else {
-                    words_failed++;
-                    std::cerr << "Warning: No valid response for address 0x" 
-                              << std::hex << addr << std::dec << std::endl;
-                }
-            } else {
-                words_failed++;
-                if (words_failed <= 5) { // Only show first few failures
-                    std::cerr << "Warning: Timeout waiting for grant at address 0x" 
-                              << std::hex << addr << std::dec << " (waited " 
-                              << MAX_WAIT_CYCLES << " cycles)" << std::endl;
-                }
-            }
-            
-            // Clear request
-            debug_bus_->req = 0;
-            debug_bus_->wen = 1; // Default to read
-            
-            // Clock a few more cycles between transactions
-            for (int i = 0; i < 3; i++) {
-                bool clk = clk_gen.tick();
-                time_ps += REF_CLK_PERIOD_PS / 2;
-                top_->eval();
-            }
-            
-            if (words_written % 50 == 0 && words_written > 0) {
-                std::cout << "  Written " << words_written << " / " << word_writes.size() 
-                          << " words (failed: " << words_failed << ")" << std::endl;
-            }
+            debug_xact_.write(w.addr, w.data, w.be);
+        }
+        
+        tb_out() << "Writing " << debug_xact_.queued() << " words to L2 memory..." << std::endl;
+        uint64_t responses_before = debug_xact_.responses();
+        uint64_t cycles = 0;
+        bool completed = run_debug_bus(sched, cycles);
+        uint64_t words_written = debug_xact_.responses() - responses_before;
+        if (!completed) {
+            words_failed += (uint32_t)debug_xact_.queued();
+            tb_err() << "Warning: Debug bus stalled for " << DEBUG_BUS_MAX_STALL
+                      << " cycles, giving up" << std::endl;
+            debug_xact_.reset();
         }
         
-        std::cout << "Memory loading complete: " << words_written << " words written, " 
-                  << words_failed << " failed" << std::endl;
+        tb_out() << "Memory loading complete: " << words_written << " words written in "
+                  << cycles << " cycles, " << words_failed << " failed" << std::endl;
         
         if (words_written == 0) {
-            std::cerr << "ERROR: No words were successfully written!" << std::endl;
-            std::cerr << "  Debug bus may not be initialized or accessible." << std::endl;
-            std::cerr << "  Try: Increase initialization wait time or check debug bus path." << std::endl;
+            tb_err() << "ERROR: No words were successfully written!" << std::endl;
+            tb_err() << "  Debug bus may not be initialized or accessible." << std::endl;
+            tb_err() << "  Try: Increase initialization wait time or check debug bus path." << std::endl;
         }
         
         return words_written > 0;
     }
     
     // Read memory through debug bus
-    bool read_memory(uint32_t addr, uint32_t& data, ClockGen& clk_gen, uint64_t& time_ps, const uint64_t REF_CLK_PERIOD_PS) {
+    bool read_memory(uint32_t addr, uint32_t& data, ClockScheduler& sched) {
         if (!debug_bus_) return false;
-        
-        // Set up read transaction
-        debug_bus_->req = 1;
-        debug_bus_->wen = 1; // 1 = read
-        debug_bus_->add = addr;
-        debug_bus_->be = 0xF;
-        
-        // Clock until grant
-        int wait_cycles = 0;
-        while (wait_cycles < 100 && !debug_bus_->gnt) {
-            bool clk = clk_gen.tick();
-            time_ps += REF_CLK_PERIOD_PS / 2;
-            top_->eval();
-            if (!clk) wait_cycles++;
-        }
-        
-        if (!debug_bus_->gnt) {
-            debug_bus_->req = 0;
+        uint32_t ticket = debug_xact_.read(addr);
+        uint64_t cycles = 0;
+        if (!run_debug_bus(sched, cycles)) {
+            debug_xact_.reset();
             return false;
         }
-        
-        // Wait for valid response
-        wait_cycles = 0;
-        while (wait_cycles < 100 && !debug_bus_->r_valid) {
-            bool clk = clk_gen.tick();
-            time_ps += REF_CLK_PERIOD_PS / 2;
-            top_->eval();
-            if (!clk) wait_cycles++;
-        }
-        
-        if (debug_bus_->r_valid) {
-            data = debug_bus_->r_rdata;
-            debug_bus_->req = 0;
-            
-            // Clock a few more cycles
-            for (int i = 0; i < 2; i++) {
-                bool clk = clk_gen.tick();
-                time_ps += REF_CLK_PERIOD_PS / 2;
-                top_->eval();
-            }
-            
-            return true;
-        }
-        
-        debug_bus_->req = 0;
-        return false;
+        return debug_xact_.read_result(ticket, data);
     }
     
-    // Check if result is available
-    bool check_result(uint32_t& cycles, ClockGen& clk_gen, uint64_t& time_ps, const uint64_t REF_CLK_PERIOD_PS) {
-        uint32_t marker = 0;
-        if (read_memory(RESULT_COMPLETE_ADDR, marker, clk_gen, time_ps, REF_CLK_PERIOD_PS)) {
-            if (marker == RESULT_MARKER) {
-                if (read_memory(RESULT_CYCLES_ADDR, cycles, clk_gen, time_ps, REF_CLK_PERIOD_PS)) {
-                    return true;
+    size_t get_write_count() const { return block_bytes_; }
+    
+private:
+    // Advance to the next clock edge and evaluate. Returns true if the main
+    // clock rose.
+    bool step(ClockScheduler& sched) {
+        bool rose = sched.advance() & sched.main_mask();
+        top_->eval();
+        return rose;
+    }
+    
+    // Clock the debug bus transactor until everything queued has been
+    // answered. The handshake is sampled after every evaluation, so at a
+    // rising edge the transactor sees the values of the cycle that ends.
+    // Returns false after DEBUG_BUS_MAX_STALL cycles without progress.
+    bool run_debug_bus(ClockScheduler& sched, uint64_t& cycles) {
+        bool gnt = false, r_valid = false;
+        uint32_t r_rdata = 0;
+        uint64_t progress = debug_xact_.granted() + debug_xact_.responses();
+        uint64_t last_progress = 0;
+        while (!debug_xact_.idle()) {
+            if (step(sched)) {
+                DebugBusTransactor::Pins p = debug_xact_.cycle(gnt, r_valid, r_rdata);
+                debug_bus_->req = p.req;
+                debug_bus_->add = p.add;
+                debug_bus_->wen = p.wen;
+                debug_bus_->wdata = p.wdata;
+                debug_bus_->be = p.be;
+                cycles++;
+                uint64_t now = debug_xact_.granted() + debug_xact_.responses();
+                if (now != progress) {
+                    progress = now;
+                    last_progress = cycles;
+                } else if (cycles - last_progress > DEBUG_BUS_MAX_STALL) {
+                    debug_bus_->req = 0;
+                    return false;
                 }
             }
+            gnt = debug_bus_->gnt;
+            r_valid = debug_bus_->r_valid;
+            r_rdata = debug_bus_->r_rdata;
         }
-        return false;
+        return true;
     }
     
-    size_t get_write_count() const { return writes_.size(); }
-    
-private:
     Vpulpissimo* top_;
     Vpulpissimo_XBAR_TCDM_BUS* debug_bus_;
-    std::map<uint32_t, uint8_t> writes_;
+    DebugBusTransactor debug_xact_;
+    struct Block {
+        uint32_t addr;
+        const uint8_t* data;
+        uint32_t len;
+    };
+    
+    L2Backdoor backdoor_;
+    std::vector<Block> blocks_;
+    size_t block_bytes_;
 };
 
-int main(int argc, char** argv) {
-    Verilated::commandArgs(argc, argv);
+// Pin the process to the CPUs in `list` ("0-3,6"). Called before the model
+// is constructed so Verilator's worker threads inherit the mask.
+bool set_cpu_affinity(const std::string& list) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        size_t dash = item.find('-');
+        int first = std::stoi(item.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(item.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)list;
+    return false;
+#endif
+}
+
+// A program range before and after the ROM -> L2 remap
+struct LoadRange {
+    uint32_t linked;
+    uint32_t addr;
+    uint32_t len;
+};
+
+// ROM-linked code is loaded at the same offset in L2, where the program may
+// also have L2 sections. Report every remapped range that lands on another
+// range; returns false if there is one.
+static bool check_remap_overlaps(std::vector<LoadRange> ranges) {
+    std::sort(ranges.begin(), ranges.end(), [](const LoadRange& a, const LoadRange& b) { return a.addr < b.addr; });
+    bool ok = true;
+    for (size_t i = 0; i < ranges.size(); i++) {
+        const LoadRange& a = ranges[i];
+        for (size_t j = i + 1; j < ranges.size() && ranges[j].addr - a.addr < a.len; j++) {
+            const LoadRange& b = ranges[j];
+            if (a.linked == a.addr && b.linked == b.addr) continue;
+            tb_err() << "Error: 0x" << std::hex << a.linked << "-0x" << a.linked + a.len << " and 0x"
+                      << b.linked << "-0x" << b.linked + b.len << " overlap at 0x" << b.addr
+                      << " once ROM addresses are remapped to L2" << std::dec << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Fast-forward from `entry` on the ISS and hand the state to the RTL. The
+// ISS starts from the L2 contents just loaded.
+static void run_iss(Vpulpissimo* top, uint32_t entry, uint32_t stop_pc, uint64_t max_instrs, bool ignore_mmio) {
+    L2Backdoor l2(top);
+    Iss iss(L2_START_ADDR, L2_END_ADDR - L2_START_ADDR, ROM_START_ADDR);
+    iss.set_ignore_mmio(ignore_mmio);
+    std::vector<uint8_t>& mem = iss.memory();
+    for (uint32_t off = 0; off < mem.size(); off += 4) {
+        uint32_t word = 0;
+        l2.read_word(L2_START_ADDR + off, word);
+        memcpy(&mem[off], &word, 4);
+    }
+    
+    tb_out() << "ISS fast-forward from 0x" << std::hex << entry << std::dec << "..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    iss.set_pc(entry);
+    Iss::StopReason reason = iss.run(stop_pc, max_instrs);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    tb_out() << "ISS stopped at 0x" << std::hex << iss.pc() << std::dec << " (" << Iss::reason_name(reason)
+              << ") after " << iss.instret() << " instructions, "
+              << tb_fixed(seconds > 0 ? iss.instret() / seconds / 1e6 : 0.0, 1) << " MIPS" << std::endl;
+    
+    if (iss.handoff(l2, entry)) {
+        tb_out() << "ISS state handed over to the RTL at the entry point" << std::endl;
+    } else {
+        tb_err() << "Warning: ISS handoff failed, the RTL runs the program from the start" << std::endl;
+    }
+}
+
+// One simulation: model, memory image, monitors and report. `elfs` shares
+// parsed ELF files between the instances of a process, nullptr for a single run.
+static int run_sim(VerilatedContext* context, int argc, char** argv, ElfCache* elfs) {
+    auto process_start = std::chrono::steady_clock::now();
+    context->commandArgs(argc, argv);
     
     // Parse command line arguments
     std::string srec_file;
+    std::string elf_file;
     uint64_t max_cycles = 10000000; // Default max cycles
-    bool vcd_trace = false;
+    bool trace_enabled = false;
+    std::string trace_file;         // Default: <program>.fst / .vcd
+    std::string trace_scope;        // e.g. i_soc_domain.i_pulp_soc
+    int trace_depth = 99;
+    uint64_t trace_start = 0;       // Window in cycles; triggers below override the start
+    uint64_t trace_stop = TraceWindow::NEVER;
+    uint64_t trace_cycles = TraceWindow::NEVER;
+    std::string trace_start_pc, trace_stop_pc;       // ELF symbol or address
+    std::string trace_start_write, trace_stop_write; // Bus write address
     bool verbose = false;
+    bool debug_bus_load = false; // Load through s_lint_debug_bus instead of backdoor
+    std::vector<std::pair<uint32_t, std::string>> stop_writes; // +stop_on_write=<addr>[:<value>]
+    std::string save_checkpoint;    // Snapshot after reset and clock warmup
+    std::string restore_checkpoint; // Skip reset and warmup by resuming a snapshot
+    unsigned threads = 0;           // Verilator threads, 0 = as built
+    std::string cpu_affinity;
+    uint64_t bench_cycles = 0;      // Throughput benchmark: run a fixed number of cycles
+    int64_t warmup_cycles = -1;     // Cycles after reset before loading, -1 = default
+    bool idle_skip = false;         // Fast-forward while the core sleeps in wfi
+    std::string profile_prefix;     // Cycle attribution: <prefix>.flat.txt / .folded
+    std::string contention_prefix;  // Interconnect stalls: <prefix>.txt / .ranges.csv
+    uint32_t contention_range = 256; // Bytes per row of the address range table
+    std::string latency_prefix;     // IRQ and peripheral access latency: <prefix>.txt / .csv
+    int irq_actuator_id = -1;       // Core interrupt id of custom_actuator_ctrl, -1 = any
+    bool perf_counters = true;      // FC event counts in the final report
+    std::string report_file;        // JSON run summary
+    std::string report_baseline;    // Report of a reference run to compute the speedup against
+    std::string iss_until;          // Fast-forward on the ISS up to this symbol or address
+    uint64_t iss_instrs = 0;        // ... or this many instructions, 0 = no limit
+    bool iss_ignore_mmio = false;   // ISS drops peripheral accesses instead of stopping
+    bool uart_enabled = false;      // UART console on the pads
+    double uart_baud = 115200.0;
+    double uart_clk_hz = 0.0;       // Peripheral clock firmware assumes, 0 = actual
+    double uart_cycles_per_bit = 0.0; // Overrides the two above
+    std::string uart_out;           // Default: stdout
+    std::string uart_in;            // stdin, pty or a file; default: no input
+    int uart_rx_pad = 1;            // pad_io bit driven as UART RX (PAD_GPIO01)
+    int dmi_port = -1;              // DMI server for debuggers, 0 = any free port, -1 = off
+    int gdb_port = -1;              // GDB remote protocol server, same values
+    bool motor_plant = false;       // DC motor on the custom_actuator_ctrl ports
+    std::string motor_params_file;
+    std::vector<std::pair<std::string, double>> motor_overrides; // +motor_<key>=<value>
+    std::string motor_trace;        // Plant state CSV
+#ifdef TB_EXTERNAL_CLOCK
+    double soc_clk_mhz = 50.0;      // Clocks fed straight into the SoC, bypassing the FLL
+    double per_clk_mhz = 50.0;
+    double tck_mhz = 0.0;           // JTAG TCK, 0 = not toggled
+#endif
     
     for (int i = 1; i < argc; i++) {
         if (strncmp(argv[i], "+srec=", 6) == 0) {
             srec_file = argv[i] + 6;
+        } else if (strncmp(argv[i], "+elf=", 5) == 0) {
+            elf_file = argv[i] + 5;
         } else if (strncmp(argv[i], "+max_cycles=", 12) == 0) {
             max_cycles = std::stoull(argv[i] + 12);
-        } else if (strcmp(argv[i], "+vcd") == 0) {
-            vcd_trace = true;
+        } else if (strcmp(argv[i], "+vcd") == 0 || strcmp(argv[i], "+trace") == 0) {
+            trace_enabled = true;
+        } else if (strncmp(argv[i], "+trace_file=", 12) == 0) {
+            trace_file = argv[i] + 12;
+        } else if (strncmp(argv[i], "+trace_scope=", 13) == 0) {
+            trace_scope = argv[i] + 13;
+        } else if (strncmp(argv[i], "+trace_depth=", 13) == 0) {
+            trace_depth = std::stoi(argv[i] + 13);
+        } else if (strncmp(argv[i], "+trace_start=", 13) == 0) {
+            trace_start = std::stoull(argv[i] + 13);
+        } else if (strncmp(argv[i], "+trace_stop=", 12) == 0) {
+            trace_stop = std::stoull(argv[i] + 12);
+        } else if (strncmp(argv[i], "+trace_cycles=", 14) == 0) {
+            trace_cycles = std::stoull(argv[i] + 14);
+        } else if (strncmp(argv[i], "+trace_start_pc=", 16) == 0) {
+            trace_start_pc = argv[i] + 16;
+        } else if (strncmp(argv[i], "+trace_stop_pc=", 15) == 0) {
+            trace_stop_pc = argv[i] + 15;
+        } else if (strncmp(argv[i], "+trace_start_write=", 19) == 0) {
+            trace_start_write = argv[i] + 19;
+        } else if (strncmp(argv[i], "+trace_stop_write=", 18) == 0) {
+            trace_stop_write = argv[i] + 18;
         } else if (strcmp(argv[i], "+verbose") == 0) {
             verbose = true;
+        } else if (strcmp(argv[i], "+debug_bus_load") == 0) {
+            debug_bus_load = true;
+        } else if (strncmp(argv[i], "+stop_on_write=", 15) == 0) {
+            std::string arg = argv[i] + 15;
+            size_t colon = arg.find(':');
+            stop_writes.emplace_back(std::stoul(arg.substr(0, colon), nullptr, 0),
+                                     colon == std::string::npos ? "" : arg.substr(colon + 1));
+        } else if (strncmp(argv[i], "+save_checkpoint=", 17) == 0) {
+            save_checkpoint = argv[i] + 17;
+        } else if (strncmp(argv[i], "+restore_checkpoint=", 20) == 0) {
+            restore_checkpoint = argv[i] + 20;
+        } else if (strncmp(argv[i], "+threads=", 9) == 0) {
+            threads = std::stoul(argv[i] + 9);
+        } else if (strncmp(argv[i], "+cpu_affinity=", 14) == 0) {
+            cpu_affinity = argv[i] + 14;
+        } else if (strncmp(argv[i], "+bench_cycles=", 14) == 0) {
+            bench_cycles = std::stoull(argv[i] + 14);
+        } else if (strncmp(argv[i], "+profile=", 9) == 0) {
+            profile_prefix = argv[i] + 9;
+        } else if (strncmp(argv[i], "+contention=", 12) == 0) {
+            contention_prefix = argv[i] + 12;
+        } else if (strncmp(argv[i], "+contention_range=", 18) == 0) {
+            contention_range = std::stoul(argv[i] + 18, nullptr, 0);
+        } else if (strncmp(argv[i], "+latency=", 9) == 0) {
+            latency_prefix = argv[i] + 9;
+        } else if (strncmp(argv[i], "+irq_actuator_id=", 17) == 0) {
+            irq_actuator_id = std::stoi(argv[i] + 17);
+        } else if (strncmp(argv[i], "+report=", 8) == 0) {
+            report_file = argv[i] + 8;
+        } else if (strncmp(argv[i], "+report_baseline=", 17) == 0) {
+            report_baseline = argv[i] + 17;
+        } else if (strncmp(argv[i], "+iss_until=", 11) == 0) {
+            iss_until = argv[i] + 11;
+        } else if (strncmp(argv[i], "+iss_instrs=", 12) == 0) {
+            iss_instrs = std::stoull(argv[i] + 12);
+        } else if (strcmp(argv[i], "+iss_mmio=ignore") == 0) {
+            iss_ignore_mmio = true;
+        } else if (strcmp(argv[i], "+no_perf") == 0) {
+            perf_counters = false;
+        } else if (strcmp(argv[i], "+uart") == 0) {
+            uart_enabled = true;
+        } else if (strncmp(argv[i], "+uart_baud=", 11) == 0) {
+            uart_baud = std::stod(argv[i] + 11);
+        } else if (strncmp(argv[i], "+uart_clk_hz=", 13) == 0) {
+            uart_clk_hz = std::stod(argv[i] + 13);
+        } else if (strncmp(argv[i], "+uart_cycles_per_bit=", 21) == 0) {
+            uart_cycles_per_bit = std::stod(argv[i] + 21);
+        } else if (strncmp(argv[i], "+uart_out=", 10) == 0) {
+            uart_out = argv[i] + 10;
+        } else if (strncmp(argv[i], "+uart_in=", 9) == 0) {
+            uart_in = argv[i] + 9;
+        } else if (strncmp(argv[i], "+uart_rx_pad=", 13) == 0) {
+            uart_rx_pad = std::stoi(argv[i] + 13);
+        } else if (strncmp(argv[i], "+dmi_server=", 12) == 0) {
+            dmi_port = std::stoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "+gdb_server=", 12) == 0) {
+            gdb_port = std::stoi(argv[i] + 12);
+        } else if (strcmp(argv[i], "+motor_plant") == 0) {
+            motor_plant = true;
+        } else if (strncmp(argv[i], "+motor_params=", 14) == 0) {
+            motor_params_file = argv[i] + 14;
+        } else if (strncmp(argv[i], "+motor_trace=", 13) == 0) {
+            motor_trace = argv[i] + 13;
+        } else if (strncmp(argv[i], "+motor_", 7) == 0 && strchr(argv[i], '=')) {
+            const char* eq = strchr(argv[i], '=');
+            motor_overrides.emplace_back(std::string(argv[i] + 7, eq - argv[i] - 7), std::stod(eq + 1));
+        } else if (strcmp(argv[i], "+idle_skip") == 0) {
+            idle_skip = true;
+        } else if (strncmp(argv[i], "+warmup_cycles=", 15) == 0) {
+            warmup_cycles = std::stoll(argv[i] + 15);
+#ifdef TB_EXTERNAL_CLOCK
+        } else if (strncmp(argv[i], "+soc_clk_mhz=", 13) == 0) {
+            soc_clk_mhz = std::stod(argv[i] + 13);
+        } else if (strncmp(argv[i], "+per_clk_mhz=", 13) == 0) {
+            per_clk_mhz = std::stod(argv[i] + 13);
+        } else if (strncmp(argv[i], "+tck_mhz=", 9) == 0) {
+            tck_mhz = std::stod(argv[i] + 9);
+#endif
         }
     }
     
-    std::cout << "================================================================================" << std::endl;
-    std::cout << "Verilator RTL Simulation - Motor Control Benchmark" << std::endl;
-    std::cout << "================================================================================" << std::endl;
+    tb_out() << "================================================================================" << std::endl;
+    tb_out() << "Verilator RTL Simulation - Motor Control Benchmark" << std::endl;
+    tb_out() << "================================================================================" << std::endl;
     
     uint32_t entry_point = 0x1A000000;
-    std::vector<SRECRecord> records;
+    MemoryImage srec_image;
+    ElfImage own_elf; // Kept mapped until the memory is loaded
+    const ElfImage* shared_elf = (elfs && !elf_file.empty()) ? elfs->get(elf_file) : nullptr;
+    const ElfImage& elf = shared_elf ? *shared_elf : own_elf;
+    bool elf_loaded = false;
+    ResultTable results; // sim_result_* globals and sim_results[], read at exit
     
-    if (!srec_file.empty()) {
-        std::cout << "SREC file: " << srec_file << std::endl;
-        records = parse_srec(srec_file, entry_point);
-        std::cout << "Parsed " << records.size() << " SREC records" << std::endl;
-        std::cout << "Entry point: 0x" << std::hex << entry_point << std::dec << std::endl;
+    if (!elf_file.empty()) {
+        tb_out() << "ELF file: " << elf_file << std::endl;
+        elf_loaded = elfs ? shared_elf != nullptr : own_elf.open(elf_file);
+        if (elf_loaded) {
+            entry_point = elf.entry();
+            tb_out() << "Parsed " << elf.segments().size() << " loadable segments, "
+                      << elf.symbols().size() << " symbols" << std::endl;
+            tb_out() << "Entry point: 0x" << std::hex << entry_point << std::dec << std::endl;
+            if (size_t n = results.locate(elf)) {
+                tb_out() << "Result symbols: " << n << " entries" << std::endl;
+            }
+        } else {
+            tb_err() << "Warning: Cannot load ELF file. Simulation will run without code." << std::endl;
+        }
+    } else if (!srec_file.empty()) {
+        tb_out() << "SREC file: " << srec_file << std::endl;
+        SrecStats stats;
+        load_srec(srec_file, srec_image, entry_point, stats);
+        tb_out() << "Parsed " << stats.records << " SREC records (" << srec_image.size() << " bytes";
+        if (stats.bad_records > 0) {
+            tb_out() << ", " << stats.bad_records << " bad records skipped";
+        }
+        tb_out() << ")" << std::endl;
+        tb_out() << "Entry point: 0x" << std::hex << entry_point << std::dec << std::endl;
         
-        if (records.empty()) {
-            std::cerr << "Warning: No SREC records found. Simulation will run without code." << std::endl;
+        if (srec_image.empty()) {
+            tb_err() << "Warning: No SREC records found. Simulation will run without code." << std::endl;
         }
     } else {
-        std::cout << "No SREC file specified - running system initialization only" << std::endl;
+        tb_out() << "No ELF or SREC file specified - running system initialization only" << std::endl;
     }
     
-    std::cout << "Max cycles: " << max_cycles << std::endl;
-    std::cout << "VCD trace: " << (vcd_trace ? "enabled" : "disabled") << std::endl;
-    std::cout << "================================================================================" << std::endl;
+    // IMPORTANT: Remap ROM addresses (0x1a000000) to L2 addresses (0x1c000000)
+    // The ROM cannot be written, so code linked for ROM is loaded into L2
+    auto remap_to_l2 = [](uint32_t addr) {
+        if (addr >= ROM_START_ADDR && addr < ROM_END_ADDR) {
+            return addr + (L2_START_ADDR - ROM_START_ADDR);
+        }
+        return addr;
+    };
     
-    // Create Verilator model
-    Vpulpissimo* top = new Vpulpissimo;
-    
-    // Initialize VCD trace if requested
-#ifdef TRACE_VCD
-    VerilatedVcdC* tfp = nullptr;
-    if (vcd_trace) {
-        Verilated::traceEverOn(true);
-        tfp = new VerilatedVcdC;
-        top->trace(tfp, 99);
-        std::string vcd_name = "simulation.vcd";
-        if (!srec_file.empty()) {
-            size_t pos = srec_file.find_last_of("/\\");
-            std::string basename = (pos != std::string::npos) ? srec_file.substr(pos+1) : srec_file;
-            size_t dot = basename.find_last_of(".");
-            vcd_name = (dot != std::string::npos) ? basename.substr(0, dot) + ".vcd" : basename + ".vcd";
-        }
-        tfp->open(vcd_name.c_str());
-        std::cout << "VCD trace file: " << vcd_name << std::endl;
+    // A program whose parts collide in L2 once remapped is rejected before
+    // the model is built
+    std::vector<LoadRange> ranges;
+    if (elf_loaded) {
+        for (const ElfImage::Segment& seg : elf.segments()) {
+            if (seg.memsz) ranges.push_back({seg.paddr, remap_to_l2(seg.paddr), seg.memsz});
+        }
+    } else {
+        srec_image.for_each_run([&](uint32_t addr, const uint8_t*, size_t len) {
+            ranges.push_back({addr, remap_to_l2(addr), (uint32_t)len});
+        });
+    }
+    if (!check_remap_overlaps(ranges)) return 1;
+    
+    tb_out() << "Max cycles: " << max_cycles << std::endl;
+    tb_out() << "Waveform trace: " << (trace_enabled ? "enabled" : "disabled") << std::endl;
+    tb_out() << "Memory load: " << (debug_bus_load ? "debug bus" : "backdoor") << std::endl;
+    tb_out() << "Idle skip: " << (idle_skip ? "enabled" : "disabled") << std::endl;
+#ifndef TB_SAVABLE
+    if (!save_checkpoint.empty() || !restore_checkpoint.empty()) {
+        tb_err() << "Error: Checkpoints need a model built with --savable (make build VERILATOR_SAVABLE=1)" << std::endl;
+        return 1;
+    }
+#endif
+    MotorParams motor_params;
+    if (motor_plant) {
+#ifndef TB_ACTUATOR_PORTS
+        tb_err() << "Error: +motor_plant needs the custom_actuator_ctrl ports (make build VERILATOR_ACTUATOR=1)" << std::endl;
+        return 1;
+#endif
+        if (!motor_params_file.empty() && !motor_params.load(motor_params_file)) return 1;
+        for (const auto& o : motor_overrides) {
+            if (!motor_params.set(o.first, o.second)) {
+                tb_err() << "Error: Unknown motor parameter +motor_" << o.first << std::endl;
+                return 1;
+            }
+        }
+    }
+    tb_out() << "================================================================================" << std::endl;
+    
+    if (!cpu_affinity.empty()) {
+        if (set_cpu_affinity(cpu_affinity)) {
+            tb_out() << "CPU affinity: " << cpu_affinity << std::endl;
+        } else {
+            tb_err() << "Warning: Cannot set CPU affinity to " << cpu_affinity << std::endl;
+        }
+    }
+    
+#ifdef TB_THREADS
+    // The thread pool size is fixed when the model is constructed and cannot
+    // exceed the partitioning chosen at build time (--threads).
+    if (threads > TB_THREADS) {
+        tb_err() << "Warning: Model built for " << TB_THREADS << " threads, using "
+                  << TB_THREADS << " instead of " << threads << std::endl;
+        threads = TB_THREADS;
     }
+    if (threads > 0) {
+        context->threads(threads);
+    }
+    if (threads == 0) threads = TB_THREADS;
+    tb_out() << "Verilator threads: " << threads << std::endl;
 #else
-    void* tfp = nullptr;
-    if (vcd_trace) {
-        std::cout << "Warning: VCD tracing not available (Verilator built without --trace)" << std::endl;
+    if (threads > 1) {
+        tb_err() << "Warning: Single-threaded model, ignoring +threads=" << threads
+                  << " (rebuild with make build_mt)" << std::endl;
     }
+    threads = 1;
 #endif
     
+    // Create Verilator model
+    Vpulpissimo* top = new Vpulpissimo(context);
+    
     // Memory accessor
     MemoryAccessor mem(top);
     
-    // Store memory writes from SREC
-    // IMPORTANT: Remap ROM addresses (0x1a000000) to L2 addresses (0x1c000000)
-    // The SREC file contains ROM addresses, but code should be loaded into L2
-    const uint32_t ROM_BASE = 0x1A000000;
-    const uint32_t L2_BASE = 0x1C000000;
-    const uint32_t ADDR_REMAP_OFFSET = L2_BASE - ROM_BASE; // 0x02000000
+    // Passive completion detection: the benchmark writes its cycle count and
+    // then RESULT_MARKER; the snooper stops the run on the marker write.
+    BusSnooper snooper(top);
+    int result_cycles_watch = snooper.watch(RESULT_CYCLES_ADDR);
+    int result_marker_watch = snooper.stop_on_value(RESULT_COMPLETE_ADDR, RESULT_MARKER);
+    int exit_watch = snooper.stop_on_bits(EXIT_REG_ADDR, EXIT_FLAG, EXIT_FLAG);
+    for (const auto& sw : stop_writes) {
+        if (sw.second.empty()) {
+            snooper.stop_on_write(sw.first);
+        } else {
+            snooper.stop_on_value(sw.first, std::stoul(sw.second, nullptr, 0));
+        }
+    }
+    std::vector<SimMonitor*> monitors;
+    monitors.push_back(&snooper);
+    
+    // FC event counts, frozen when the benchmark writes its result marker
+    PerfCounters perf(top);
+    perf.freeze_on_write(&snooper, result_marker_watch);
+    if (perf_counters) {
+        monitors.push_back(&perf);
+    }
     
-    if (!records.empty()) {
-        std::cout << std::endl << "Preparing memory loading..." << std::endl;
+    // Per-function cycle attribution needs the ELF symbol table
+    Profiler* profiler = nullptr;
+    if (!profile_prefix.empty()) {
+        if (elf_loaded) {
+            profiler = new Profiler(top, elf);
+            monitors.push_back(profiler);
+            tb_out() << "Profiling cycles per function: " << profile_prefix << ".{flat.txt,folded}" << std::endl;
+        } else {
+            tb_err() << "Warning: +profile needs an ELF file with symbols (+elf=), profiling disabled" << std::endl;
+        }
+    }
+    
+    // Interconnect stalls per master, bank and address range, frozen with the
+    // FC counters
+    ContentionProfiler* contention = nullptr;
+    if (!contention_prefix.empty()) {
+        contention = new ContentionProfiler(top, elf_loaded ? &elf : nullptr, contention_range);
+        contention->freeze_on_write(&snooper, result_marker_watch);
+        monitors.push_back(contention);
+        tb_out() << "Profiling interconnect contention: " << contention_prefix << ".{txt,ranges.csv}" << std::endl;
+    }
+    
+    // Interrupt and peripheral access latencies over the whole run
+    LatencyMonitor* latency = nullptr;
+    if (!latency_prefix.empty()) {
+        latency = new LatencyMonitor(top);
+        latency->set_actuator_id(irq_actuator_id);
+        monitors.push_back(latency);
+        tb_out() << "Measuring interrupt and peripheral latency: " << latency_prefix << ".{txt,csv}" << std::endl;
+    }
+    
+    // PC triggers and markers take an ELF symbol name or a numeric address
+    auto resolve = [&](const std::string& arg) -> uint32_t {
+        const ElfImage::Symbol* sym = elf_loaded ? elf.find_symbol(arg) : nullptr;
+        return sym ? sym->addr : (uint32_t)std::stoul(arg, nullptr, 0);
+    };
+    
+    // Waveform trace, limited to a window and scope if requested
+    TraceWindow tracer(top);
+    if (trace_enabled) {
+        tracer.set_scope(trace_scope);
+        tracer.set_depth(trace_depth);
+        tracer.start_at_cycle(trace_start);
+        tracer.stop_at_cycle(trace_stop);
+        tracer.set_length(trace_cycles);
+        if (!trace_start_pc.empty()) tracer.start_at_pc(resolve(trace_start_pc));
+        if (!trace_stop_pc.empty()) tracer.stop_at_pc(resolve(trace_stop_pc));
+        if (!trace_start_write.empty()) {
+            tracer.start_on_write(&snooper, snooper.watch(std::stoul(trace_start_write, nullptr, 0)));
+        }
+        if (!trace_stop_write.empty()) {
+            tracer.stop_on_write(&snooper, snooper.watch(std::stoul(trace_stop_write, nullptr, 0)));
+        }
+        
+        if (trace_file.empty()) {
+            trace_file = "simulation" TRACE_FILE_EXT;
+            const std::string& program_file = elf_file.empty() ? srec_file : elf_file;
+            if (!program_file.empty()) {
+                size_t pos = program_file.find_last_of("/\\");
+                std::string basename = (pos != std::string::npos) ? program_file.substr(pos+1) : program_file;
+                size_t dot = basename.find_last_of(".");
+                trace_file = ((dot != std::string::npos) ? basename.substr(0, dot) : basename) + TRACE_FILE_EXT;
+            }
+        }
+        if (tracer.open(trace_file)) {
+            tb_out() << "Trace file: " << trace_file
+                      << (trace_scope.empty() ? "" : " (scope " + trace_scope + ")") << std::endl;
+            monitors.push_back(&tracer);
+        } else {
+            tb_out() << "Warning: Waveform tracing not available (build with VERILATOR_TRACE=fst or vcd)" << std::endl;
+        }
+    }
+    
+    // Releases the model and everything created with it so far, at the end of
+    // the run or when it cannot start
+    auto teardown = [&]() {
+        top->final();
+        tracer.close();
+        delete profiler;
+        delete contention;
+        delete latency;
+        delete top;
+    };
+    
+    // Store memory writes from the ELF or SREC image, ROM parts remapped to L2
+    const uint32_t L2_BASE = L2_START_ADDR;
+    if (elf_loaded) {
+        tb_out() << std::endl << "Preparing memory loading..." << std::endl;
         uint32_t total_bytes = 0;
-        for (const auto& rec : records) {
-            if (rec.type == SREC_DATA_32BIT) {
-                // Remap ROM addresses to L2 addresses
-                uint32_t l2_addr = rec.address;
-                if (l2_addr >= ROM_BASE && l2_addr < ROM_BASE + 0x2000) {
-                    l2_addr = rec.address + ADDR_REMAP_OFFSET;
-                }
-                
-                for (size_t i = 0; i < rec.data.size(); i++) {
-                    mem.write_memory(l2_addr + i, rec.data[i]);
-                    total_bytes++;
-                }
+        for (const ElfImage::Segment& seg : elf.segments()) {
+            uint32_t addr = remap_to_l2(seg.paddr);
+            mem.write_block(addr, seg.data, seg.filesz);
+            mem.write_block(addr + seg.filesz, nullptr, seg.memsz - seg.filesz);
+            total_bytes += seg.memsz;
+            if (verbose) {
+                tb_out() << "  Segment 0x" << std::hex << seg.paddr << " -> 0x" << addr << std::dec
+                          << " (" << seg.filesz << " bytes, " << (seg.memsz - seg.filesz)
+                          << " zero-filled)" << std::endl;
             }
         }
-        std::cout << "Prepared " << total_bytes << " bytes for loading (remapped to L2: 0x" 
+        tb_out() << "Prepared " << total_bytes << " bytes in " << elf.segments().size()
+                  << " segments for loading" << std::endl;
+    } else if (!srec_image.empty()) {
+        tb_out() << std::endl << "Preparing memory loading..." << std::endl;
+        size_t total_bytes = 0;
+        size_t runs = 0;
+        srec_image.for_each_run([&](uint32_t addr, const uint8_t* data, size_t len) {
+            // Remap ROM addresses to L2 addresses
+            mem.write_block(remap_to_l2(addr), data, len);
+            total_bytes += len;
+            runs++;
+        });
+        tb_out() << "Prepared " << total_bytes << " bytes in " << runs << " runs for loading (remapped to L2: 0x" 
                   << std::hex << L2_BASE << std::dec << ")" << std::endl;
     }
     
-    // Clock generator
-    ClockGen clk_gen;
+    // Clocks. The model is only evaluated on real edges; with several
+    // clocks, "cycles" below are rising edges of the main clock.
+    ClockScheduler sched;
     
     // Reference clock period (32.769 kHz = 30517 ns)
     const uint64_t REF_CLK_PERIOD_PS = 30517000; // in picoseconds
-    uint64_t time_ps = 0;
-    
-    std::cout << std::endl << "Initializing system..." << std::endl;
-    
-    // Reset sequence - assert reset for several cycles
-    uint64_t reset_cycles = 0;
-    const uint64_t RESET_CYCLES = 10;
+#ifdef TB_EXTERNAL_CLOCK
+    // Built with EXTERNAL_CLOCK: drive the SoC and peripheral clocks directly
+    // instead of waiting for the FLL model to produce them from the 32 kHz
+    // reference. The SoC clock is the main clock.
+    int slow_clk = sched.add_clock("slow", REF_CLK_PERIOD_PS, &TB_PORT_SLOW_CLK(top));
+    int soc_clk = sched.add_clock("soc", (uint64_t)(1e6 / soc_clk_mhz), &TB_PORT_SOC_CLK(top));
+    int per_clk = sched.add_clock("per", (uint64_t)(1e6 / per_clk_mhz), &TB_PORT_PER_CLK(top));
+    if (tck_mhz > 0 && (dmi_port >= 0 || gdb_port >= 0)) {
+        tb_err() << "Warning: +dmi_server and +gdb_server drive TCK themselves, ignoring +tck_mhz" << std::endl;
+    } else if (tck_mhz > 0) {
+        sched.add_clock("tck", (uint64_t)(1e6 / tck_mhz), &TB_PORT_JTAG_TCK(top));
+    }
+    sched.set_main(soc_clk);
+    if (warmup_cycles < 0) warmup_cycles = 100;
+#else
+    int slow_clk = -1; // The reference clock is the main clock
+    sched.set_main(sched.add_clock("ref", REF_CLK_PERIOD_PS, &TB_PORT_REF_CLK(top)));
+    int per_clk = -1; // Generated by the FLL, frequency not known here
+    if (warmup_cycles < 0) warmup_cycles = 10000;
+#endif
+    for (size_t c = 0; c < sched.num_clocks(); c++) {
+        tb_out() << "Clock " << sched.name(c) << ": " << tb_fixed(1e6 / sched.period_ps(c), 3) << " MHz"
+                  << ((int)c == sched.main_clock() ? " (main)" : "") << std::endl;
+    }
     
-    std::cout << "Asserting reset..." << std::endl;
+    bool have_program = mem.get_write_count() > 0;
     
-    while (reset_cycles < RESET_CYCLES) {
-        bool clk = clk_gen.tick();
-        time_ps += REF_CLK_PERIOD_PS / 2;
-        
-        top->eval();
-        
-#ifdef TRACE_VCD
-        if (tfp && clk) {
-            ((VerilatedVcdC*)tfp)->dump(time_ps);
+    if (!restore_checkpoint.empty()) {
+#ifdef TB_SAVABLE
+        // Resume from a post-reset, clocks-settled snapshot. Only the memory
+        // image below is specific to this run.
+        tb_out() << std::endl << "Restoring checkpoint: " << restore_checkpoint << std::endl;
+        if (!restore_model(top, sched, restore_checkpoint)) {
+            tb_err() << "ERROR: Cannot restore checkpoint " << restore_checkpoint << std::endl;
+            teardown();
+            return 1;
         }
+        tb_out() << "Checkpoint restored at cycle " << sched.get_cycle() << std::endl;
 #endif
+    } else {
+        tb_out() << std::endl << "Initializing system..." << std::endl;
         
-        if (!clk) {
-            reset_cycles++;
-        }
-    }
-    
-    std::cout << "Releasing reset..." << std::endl;
-    
-    // Load memory through debug bus after reset
-    if (mem.get_write_count() > 0) {
-        std::cout << "Attempting memory load through debug bus..." << std::endl;
+        // Reset sequence - assert reset for several cycles
+        uint64_t reset_cycles = 0;
+        const uint64_t RESET_CYCLES = 10;
+        
+        tb_out() << "Asserting reset..." << std::endl;
         
-        // Wait longer for system initialization - debug bus needs time to stabilize
-        // The interconnect and debug module need to be fully initialized
-        // IMPORTANT: Debug bus uses SoC clock (generated from ref clock via FLL)
-        // We need many reference clock cycles to ensure SoC clock domain is stable
-        std::cout << "Waiting for system initialization (10000 ref clock cycles)..." << std::endl;
-        std::cout << "  This allows SoC clock domain (FLL) to stabilize..." << std::endl;
-        for (int i = 0; i < 10000; i++) {
-            bool clk = clk_gen.tick();
-            time_ps += REF_CLK_PERIOD_PS / 2;
+        while (reset_cycles < RESET_CYCLES) {
+            bool clk = sched.advance() & sched.main_mask();
+            
             top->eval();
+            tracer.dump(sched.time_ps());
             
-            if (i % 2000 == 0 && i > 0) {
-                std::cout << "  Initialized " << i << " ref clock cycles..." << std::endl;
+            if (clk) {
+                reset_cycles++;
             }
         }
-        std::cout << "System initialization complete. Starting memory load..." << std::endl;
         
-        bool loaded = mem.load_memory(clk_gen, time_ps, REF_CLK_PERIOD_PS);
+        tb_out() << "Releasing reset..." << std::endl;
+        
+        if (have_program || !save_checkpoint.empty()) {
+            // Wait longer for system initialization - debug bus needs time to stabilize
+            // The interconnect and debug module need to be fully initialized
+            // IMPORTANT: Debug bus uses SoC clock. Through the FLL we need many
+            // reference clock cycles to ensure the SoC clock domain is stable;
+            // with directly driven clocks a short settle is enough.
+            tb_out() << "Waiting for system initialization (" << warmup_cycles << " "
+                      << sched.name(sched.main_clock()) << " clock cycles)..." << std::endl;
+            uint64_t warmup_end = sched.get_cycle() + warmup_cycles;
+            uint64_t next_note = sched.get_cycle() + 2000;
+            while (sched.get_cycle() < warmup_end) {
+                sched.advance();
+                top->eval();
+                
+                if (sched.get_cycle() >= next_note) {
+                    tb_out() << "  Initialized " << sched.get_cycle() << " cycles..." << std::endl;
+                    next_note += 2000;
+                }
+            }
+            tb_out() << "System initialization complete." << std::endl;
+        }
+        
+#ifdef TB_SAVABLE
+        // The snapshot is taken before any program is loaded so it can be
+        // reused with any memory image.
+        if (!save_checkpoint.empty()) {
+            if (save_model(top, sched, save_checkpoint)) {
+                tb_out() << "Checkpoint saved: " << save_checkpoint
+                          << " (cycle " << sched.get_cycle() << ")" << std::endl;
+            } else {
+                tb_err() << "ERROR: Cannot write checkpoint " << save_checkpoint << std::endl;
+            }
+        }
+#endif
+    }
+    
+    // Load memory. The backdoor path writes the SRAM arrays directly; the
+    // debug bus path is kept for bring-up checks of the interconnect
+    // (+debug_bus_load).
+    double load_seconds = 0.0;
+    if (have_program) {
+        auto load_start = std::chrono::steady_clock::now();
+        bool loaded = false;
+        if (debug_bus_load) {
+            tb_out() << "Attempting memory load through debug bus..." << std::endl;
+            loaded = mem.load_memory(sched);
+        } else {
+            loaded = mem.preload_memory();
+        }
+        load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - load_start).count();
         if (loaded) {
-            std::cout << "Memory loaded successfully. Code execution enabled." << std::endl;
+            tb_out() << "Memory loaded successfully. Code execution enabled." << std::endl;
             // Update entry point to L2 memory
             if (entry_point >= ROM_START_ADDR && entry_point < ROM_END_ADDR) {
                 entry_point = entry_point + (L2_START_ADDR - ROM_START_ADDR);
-                std::cout << "Entry point remapped to L2: 0x" << std::hex << entry_point << std::dec << std::endl;
+                tb_out() << "Entry point remapped to L2: 0x" << std::hex << entry_point << std::dec << std::endl;
+            }
+            if (!iss_until.empty() || iss_instrs > 0) {
+                run_iss(top, entry_point, iss_until.empty() ? 0xFFFFFFFFu : resolve(iss_until),
+                        iss_instrs > 0 ? iss_instrs : UINT64_MAX, iss_ignore_mmio);
             }
         } else {
-            std::cout << "ERROR: Memory loading failed - debug bus not responding" << std::endl;
-            std::cout << "  Possible causes:" << std::endl;
-            std::cout << "    1. Debug bus needs JTAG initialization" << std::endl;
-            std::cout << "    2. Debug module needs to be activated" << std::endl;
-            std::cout << "    3. System needs more initialization cycles" << std::endl;
-            std::cout << "    4. Debug bus path may be incorrect" << std::endl;
-            std::cout << std::endl;
-            std::cout << "  Simulation will continue but code may not execute correctly." << std::endl;
+            tb_out() << "ERROR: Memory loading failed - "
+                      << (debug_bus_load ? "debug bus not responding" : "no bytes landed in L2") << std::endl;
+            tb_out() << "  Possible causes:" << std::endl;
+            tb_out() << "    1. Debug bus needs JTAG initialization" << std::endl;
+            tb_out() << "    2. Debug module needs to be activated" << std::endl;
+            tb_out() << "    3. System needs more initialization cycles" << std::endl;
+            tb_out() << "    4. Debug bus path may be incorrect" << std::endl;
+            tb_out() << std::endl;
+            tb_out() << "  Simulation will continue but code may not execute correctly." << std::endl;
+        }
+    }
+    
+    // UART console. The bit time follows from the divisor firmware programs:
+    // (uart_clk_hz / baud) cycles of the peripheral clock it actually gets.
+    UartModel* uart = nullptr;
+    if (uart_enabled) {
+        double cycles_per_bit = uart_cycles_per_bit;
+        if (cycles_per_bit <= 0) {
+            double per_period_ps = per_clk >= 0 ? (double)sched.period_ps(per_clk) : 0.0;
+            double bit_ps = (uart_clk_hz > 0 && per_period_ps > 0)
+                ? uart_clk_hz / uart_baud * per_period_ps
+                : 1e12 / uart_baud;
+            cycles_per_bit = bit_ps / sched.period_ps(sched.main_clock());
+        }
+        uart = new UartModel(top, cycles_per_bit, uart_rx_pad);
+        if (!uart->open_output(uart_out)) {
+            tb_err() << "Error: Cannot write UART output " << uart_out << std::endl;
+        }
+        if (!uart_in.empty() && !uart->open_input(uart_in)) {
+            tb_err() << "Error: Cannot open UART input " << uart_in << std::endl;
+        }
+        tb_out() << "UART: " << uart_baud << " baud, " << tb_fixed(cycles_per_bit, 2) << " cycles per bit, RX on pad "
+                  << uart_rx_pad << std::endl;
+        if (cycles_per_bit < 4) {
+            tb_err() << "Warning: UART bits are too short to sample on the "
+                      << sched.name(sched.main_clock()) << " clock"
+                      << " (build with VERILATOR_DIRECT_CLOCK=1 or lower the baud rate)" << std::endl;
+        }
+        monitors.push_back(uart);
+    }
+    
+    // Motor on the actuator outputs; its sensor drives the feedback input
+    MotorPlant* plant = nullptr;
+    if (motor_plant) {
+        plant = new MotorPlant(top, sched, motor_params);
+        if (!motor_trace.empty() && !plant->open_trace(motor_trace)) {
+            tb_err() << "Error: Cannot write motor trace " << motor_trace << std::endl;
+        }
+        tb_out() << "Motor plant parameters:" << std::endl;
+        motor_params.print(tb_out());
+        monitors.push_back(plant);
+    }
+    
+    // Debugger access: DMI operations from a socket client, scanned into the
+    // debug TAP on the JTAG pins (dmi_client.py speaks the protocol)
+    DmiServer* dmi_server = nullptr;
+    JtagDtm* dtm = nullptr;
+    if (dmi_port >= 0 && gdb_port >= 0) {
+        tb_err() << "Warning: +gdb_server and +dmi_server both need the JTAG pins, ignoring +dmi_server" << std::endl;
+        dmi_port = -1;
+    }
+    if (dmi_port >= 0) {
+        dmi_server = new DmiServer;
+        if (dmi_server->listen(dmi_port)) {
+            tb_out() << "DMI server listening on port " << dmi_server->port() << std::endl;
+            dtm = new JtagDtm(top, dmi_server);
+            monitors.push_back(dtm);
+        } else {
+            delete dmi_server;
+            dmi_server = nullptr;
+        }
+    }
+    
+    // Or GDB straight on a socket: memory through the backdoor, run control
+    // through the debug module. Waits for GDB before the first cycle.
+    GdbServer* gdb = nullptr;
+    if (gdb_port >= 0) {
+        gdb = new GdbServer(top, sched, ROM_START_ADDR, ROM_END_ADDR - ROM_START_ADDR, L2_START_ADDR);
+        if (gdb->listen(gdb_port)) {
+            monitors.push_back(gdb);
+        } else {
+            delete gdb;
+            gdb = nullptr;
         }
     }
     
@@ -528,82 +1055,308 @@ int main(int argc, char** argv) {
     bool result_found = false;
     uint64_t result_cycle = 0;
     
-    std::cout << "Starting simulation..." << std::endl;
-    if (!records.empty()) {
-        std::cout << "  Waiting for benchmark completion (checking result location 0x" 
-                  << std::hex << RESULT_COMPLETE_ADDR << std::dec << ")..." << std::endl;
+    bool stop = false;
+    int exit_status = 0;
+    
+    tb_out() << "Starting simulation..." << std::endl;
+    if (have_program) {
+        tb_out() << "  Waiting for benchmark completion (snooping writes to 0x" 
+                  << std::hex << RESULT_COMPLETE_ADDR << " and exit() at 0x" << EXIT_REG_ADDR
+                  << std::dec << ")..." << std::endl;
     }
-    std::cout << "  (Press Ctrl+C to stop early)" << std::endl;
+    tb_out() << "  (Press Ctrl+C to stop early)" << std::endl;
     
-    while (cycle_count < max_cycles && !result_found) {
-        bool clk = clk_gen.tick();
-        time_ps += REF_CLK_PERIOD_PS / 2;
+    if (bench_cycles > 0) {
+        max_cycles = sched.get_cycle() + bench_cycles;
+        tb_out() << "  Throughput benchmark: " << bench_cycles << " cycles" << std::endl;
+    }
+    IdleSkipper skipper(top, slow_clk);
+    uint64_t run_start_cycle = sched.get_cycle();
+    auto run_start = std::chrono::steady_clock::now();
+    // Timing every eval() is only worth its cost when someone reads the report
+    const bool time_eval = !report_file.empty();
+    std::chrono::steady_clock::duration eval_time(0);
+    
+    while (cycle_count < max_cycles && !stop) {
+        bool clk = sched.advance() & sched.main_mask();
         
-        // Evaluate model
-        top->eval();
+        // Monitors see the state the design is about to register
+        if (clk) {
+            for (SimMonitor* m : monitors) {
+                m->sample(sched.get_cycle());
+                stop |= m->stop_requested();
+            }
+        }
         
-        // Dump VCD on clock edges
-#ifdef TRACE_VCD
-        if (tfp && clk) {
-            ((VerilatedVcdC*)tfp)->dump(time_ps);
+        // Evaluate model
+        if (time_eval) {
+            auto eval_start = std::chrono::steady_clock::now();
+            top->eval();
+            eval_time += std::chrono::steady_clock::now() - eval_start;
+        } else {
+            top->eval();
         }
-#endif
         
-        if (!clk) {
-            cycle_count = clk_gen.get_cycle();
+        // Dump every evaluated edge inside the trace window
+        tracer.dump(sched.time_ps());
+        
+        if (clk) {
+            // Blocks while GDB has the core halted
+            if (gdb) gdb->service(sched.get_cycle());
             
-            // Try to read result from memory
-            if (!records.empty() && cycle_count > 1000 && cycle_count % 1000 == 0) {
-                if (mem.check_result(result_cycles, clk_gen, time_ps, REF_CLK_PERIOD_PS)) {
-                    result_found = true;
-                    result_cycle = cycle_count;
-                }
+            // Jump over cycles where the core sleeps and nothing can wake it
+            uint64_t skip_limit = uart ? std::min(max_cycles, uart->next_event(sched.get_cycle())) : max_cycles;
+            if (dtm && !dtm->idle()) skip_limit = sched.get_cycle();
+            // The PWM keeps running while the core sleeps and the motor moves
+            if (plant) skip_limit = sched.get_cycle();
+            if (idle_skip && !stop && skipper.step(sched, skip_limit) > 0) {
+                tracer.dump(sched.time_ps());
             }
+            cycle_count = sched.get_cycle();
             
             // Periodic status reports
             if (cycle_count - last_report_cycle >= REPORT_INTERVAL) {
-                std::cout << "  Cycle: " << std::setw(10) << cycle_count 
-                          << "  Time: " << std::setw(12) << (time_ps / 1000) << " ns";
-                if (result_found) {
-                    std::cout << "  [Result found: " << result_cycles << " cycles]";
-                }
-                std::cout << std::endl;
+                tb_out() << "  Cycle: " << std::setw(10) << cycle_count 
+                          << "  Time: " << std::setw(12) << (sched.time_ps() / 1000) << " ns" << std::endl;
                 last_report_cycle = cycle_count;
             }
         }
     }
     
-    std::cout << std::endl;
-    std::cout << "================================================================================" << std::endl;
-    std::cout << "Simulation Complete" << std::endl;
-    std::cout << "================================================================================" << std::endl;
-    std::cout << "Total Cycles: " << cycle_count << std::endl;
-    std::cout << "Simulation Time: " << (time_ps / 1000000.0) << " us" << std::endl;
+    if (snooper.stop_watch() == result_marker_watch) {
+        const BusSnooper::Watch& marker = snooper.get_watch(result_marker_watch);
+        result_found = true;
+        result_cycle = marker.cycle;
+        result_cycles = snooper.get_watch(result_cycles_watch).value;
+    } else if (snooper.stop_watch() == exit_watch) {
+        const BusSnooper::Watch& w = snooper.get_watch(exit_watch);
+        exit_status = (int)(w.value & ~EXIT_FLAG);
+        tb_out() << "Program exited with status " << exit_status << " at cycle " << w.cycle << std::endl;
+    } else if (snooper.stop_watch() >= 0) {
+        const BusSnooper::Watch& w = snooper.get_watch(snooper.stop_watch());
+        tb_out() << "Stopped on write of 0x" << std::hex << w.value << " to 0x" << w.addr
+                  << std::dec << " at cycle " << w.cycle << std::endl;
+    }
     
-    if (result_found) {
-        std::cout << "Result found at cycle: " << result_cycle << std::endl;
-        std::cout << "Benchmark Cycles: " << result_cycles << std::endl;
-        std::cout << "================================================================================" << std::endl;
-        std::cout << "RTL SIMULATION RESULT: " << result_cycles << " cycles" << std::endl;
-        std::cout << "================================================================================" << std::endl;
-    } else if (!records.empty()) {
-        std::cout << "Note: Benchmark completion not detected" << std::endl;
-        std::cout << "      Memory loading needed for code execution" << std::endl;
-        std::cout << "      Using instruction-level estimate: 210.5 cycles (baseline) / 141.5 cycles (custom IP)" << std::endl;
+    tb_out() << std::endl;
+    tb_out() << "================================================================================" << std::endl;
+    tb_out() << "Simulation Complete" << std::endl;
+    tb_out() << "================================================================================" << std::endl;
+    tb_out() << "Total Cycles: " << cycle_count << std::endl;
+    tb_out() << "Simulation Time: " << (sched.time_ps() / 1000000.0) << " us" << std::endl;
+    
+    double run_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+    uint64_t run_cycles = sched.get_cycle() - run_start_cycle;
+    tb_out() << "Simulated cycles per second: "
+              << tb_fixed(run_seconds > 0 ? run_cycles / run_seconds : 0.0, 1)
+              << " (" << run_cycles << " cycles in " << run_seconds << " s)" << std::endl;
+    if (idle_skip) {
+        tb_out() << "Idle cycles skipped: " << skipper.skipped_cycles() << " in "
+                  << skipper.skips() << " jumps" << std::endl;
     }
     
-    std::cout << "================================================================================" << std::endl;
+    if (uart) {
+        tb_out() << "UART: " << uart->tx_bytes() << " bytes sent, " << uart->rx_bytes()
+                  << " bytes received";
+        if (uart->framing_errors()) tb_out() << ", " << uart->framing_errors() << " framing errors";
+        tb_out() << std::endl;
+        delete uart;
+    }
     
-    // Cleanup
-    top->final();
-#ifdef TRACE_VCD
-    if (tfp) {
-        ((VerilatedVcdC*)tfp)->close();
-        delete (VerilatedVcdC*)tfp;
+    if (dtm) {
+        tb_out() << "DMI: " << dtm->dmi_ops() << " operations in " << dtm->tck_cycles()
+                  << " TCK cycles, " << dtm->busy_retries() << " busy retries" << std::endl;
+        if (dmi_server->quit()) {
+            tb_out() << "DMI client ended the simulation with exit code " << dmi_server->exit_code() << std::endl;
+            exit_status = dmi_server->exit_code();
+        }
+        delete dtm;
+        delete dmi_server;
+    }
+    
+    if (gdb) {
+        tb_out() << "GDB: " << gdb->packets() << " packets, " << gdb->dmi_ops() << " DMI operations" << std::endl;
+        gdb->finish(exit_status);
+        delete gdb;
+    }
+    
+    if (plant) {
+        tb_out() << "Motor plant: " << tb_fixed(plant->position_rev(), 3) << " rev, "
+                  << tb_fixed(plant->speed_rpm(), 1) << " rpm, " << tb_fixed(plant->current_a(), 3)
+                  << " A, feedback " << plant->feedback() << std::endl;
+        if (!plant->enable_cycle()) {
+            tb_out() << "Motor plant: actuator never enabled" << std::endl;
+        } else if (plant->measuring()) {
+            tb_out() << "Motor plant: enabled at cycle " << plant->enable_cycle() << ", ";
+            if (plant->settle_us() >= 0) {
+                tb_out() << "settled after " << plant->settle_us() << " us";
+            } else {
+                tb_out() << "not settled";
+            }
+            tb_out() << ", overshoot " << plant->overshoot() * 100 << "%" << std::endl;
+        }
+    }
+    
+    if (perf_counters && have_program) {
+        perf.print();
+    }
+    
+    if (profiler) {
+        // Skipped idle cycles are never sampled and do not show up as sleep
+        profiler->print_top(10);
+        if (!profiler->write(profile_prefix)) {
+            tb_err() << "Error: Cannot write profile " << profile_prefix << ".{flat.txt,folded}" << std::endl;
+        }
+    }
+    
+    if (contention) {
+        contention->print_summary(10);
+        if (!contention->write(contention_prefix)) {
+            tb_err() << "Error: Cannot write contention profile " << contention_prefix << ".{txt,ranges.csv}" << std::endl;
+        }
+    }
+    
+    if (latency) {
+        latency->print_summary();
+        if (!latency->write(latency_prefix)) {
+            tb_err() << "Error: Cannot write latency histograms " << latency_prefix << ".{txt,csv}" << std::endl;
+        }
     }
+    
+    if (!results.empty()) {
+        L2Backdoor l2(top);
+        results.read(l2);
+        results.print();
+    }
+    
+    if (result_found) {
+        tb_out() << "Result found at cycle: " << result_cycle << std::endl;
+        tb_out() << "Benchmark Cycles: " << result_cycles << std::endl;
+        tb_out() << "================================================================================" << std::endl;
+        tb_out() << "RTL SIMULATION RESULT: " << result_cycles << " cycles" << std::endl;
+        tb_out() << "================================================================================" << std::endl;
+    } else if (have_program) {
+        tb_out() << "Note: Benchmark completion not detected" << std::endl;
+        tb_out() << "      (no result marker write or exit() within " << max_cycles << " cycles)" << std::endl;
+    }
+    
+    tb_out() << "================================================================================" << std::endl;
+    
+    if (!report_file.empty()) {
+        RunReport report;
+        const std::string& program_file = elf_file.empty() ? srec_file : elf_file;
+        report.set("program", program_file);
+        if (result_found) {
+            report.set("result", "pass");
+        } else if (snooper.stop_watch() == exit_watch) {
+            report.set("result", "exit");
+        } else if (snooper.stop_watch() >= 0) {
+            report.set("result", "stop_on_write");
+        } else {
+            report.set("result", have_program ? "incomplete" : "no_program");
+        }
+        if (result_found) {
+            report.set("benchmark_cycles", (uint64_t)result_cycles);
+            report.set("result_cycle", result_cycle);
+        } else {
+            report.set_null("benchmark_cycles");
+            report.set_null("result_cycle");
+        }
+        if (snooper.stop_watch() == exit_watch) {
+            report.set("exit_status", exit_status);
+        } else {
+            report.set_null("exit_status");
+        }
+        report.set("cycles", cycle_count);
+        report.set("run_cycles", run_cycles);
+        report.set("idle_skipped_cycles", idle_skip ? skipper.skipped_cycles() : 0);
+        report.set("sim_time_us", sched.time_ps() / 1e6);
+        double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - process_start).count();
+        double eval_seconds = std::chrono::duration<double>(eval_time).count();
+        report.set("wall_s", wall_seconds);
+        report.set("run_s", run_seconds);
+        double sim_khz = run_seconds > 0 ? run_cycles / run_seconds / 1e3 : 0.0;
+        report.set("sim_khz", sim_khz);
+        double baseline_khz = 0.0;
+        if (!report_baseline.empty()) {
+            if (RunReport::read_number(report_baseline, "sim_khz", baseline_khz) && baseline_khz > 0) {
+                report.set("baseline_khz", baseline_khz);
+                report.set("speedup", sim_khz / baseline_khz);
+            } else {
+                tb_err() << "Warning: No sim_khz in baseline report " << report_baseline << std::endl;
+            }
+        }
+        report.set("eval_s", eval_seconds);
+        report.set("harness_s", run_seconds - eval_seconds);
+        report.set("load_s", load_seconds);
+        report.set("main_clock", sched.name(sched.main_clock()));
+        report.set("main_clock_mhz", 1e6 / sched.period_ps(sched.main_clock()));
+        report.set("threads", threads);
+#if defined(TB_PGO_USE)
+        report.set("pgo", "use");
+#elif defined(TB_PGO_GEN)
+        report.set("pgo", "gen");
+#else
+        report.set("pgo", "none");
 #endif
-    delete top;
+        report.set("peak_rss_kb", RunReport::peak_rss_kb());
+        if (!results.empty()) report.set("results", results.values());
+        if (plant && plant->measuring() && plant->enable_cycle()) {
+            report.set("motor_enable_cycle", plant->enable_cycle());
+            if (plant->settle_us() >= 0) {
+                report.set("motor_settle_us", plant->settle_us());
+            } else {
+                report.set_null("motor_settle_us");
+            }
+            report.set("motor_overshoot", plant->overshoot());
+        }
+        if (contention) report.set("contention_stalls", contention->master_stalls());
+        if (latency) report.set("latency_p99", latency->p99());
+        if (report.write(report_file)) {
+            tb_out() << "Run report: " << report_file << std::endl;
+        } else {
+            tb_err() << "Error: Cannot write run report " << report_file << std::endl;
+        }
+    }
     
-    return 0;
+    // Cleanup
+    delete plant;
+    teardown();
+    
+    // The shell only sees the low 8 bits; keep a nonzero status nonzero
+    if (exit_status != 0 && (exit_status & 0xFF) == 0) return 1;
+    return exit_status;
 }
 
+int main(int argc, char** argv) {
+    // +instances=<file> runs several SoCs in this process; every other
+    // plusarg is common to all of them
+    std::string instance_list;
+    unsigned jobs = 0;
+    std::vector<std::string> common;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "+instances=", 11) == 0) {
+            instance_list = argv[i] + 11;
+        } else if (strncmp(argv[i], "+jobs=", 6) == 0) {
+            jobs = (unsigned)std::stoul(argv[i] + 6);
+        } else {
+            common.push_back(argv[i]);
+        }
+    }
+    
+    if (instance_list.empty()) {
+        std::unique_ptr<VerilatedContext> context(new VerilatedContext);
+        return run_sim(context.get(), argc, argv, nullptr);
+    }
+    
+    std::vector<InstanceSpec> specs;
+    if (!read_instance_list(instance_list, specs)) return 1;
+    if (specs.empty()) {
+        tb_err() << "Error: No instances in " << instance_list << std::endl;
+        return 1;
+    }
+    ElfCache elfs;
+    return run_instances(specs, argv[0], common, jobs, [&elfs](VerilatedContext* context, int argc, char** argv) {
+        return run_sim(context, argc, argv, &elfs);
+    });
+}
@@ -0,0 +1,161 @@
+// Copyright 2025 Custom IP Integration
+// Windowed waveform tracing for the Verilator harness.
+//
+// The trace file (FST with TRACE_FST, VCD with TRACE_VCD) is opened once, but
+// dump() only writes while the window is open. The window opens and closes on
+// a cycle count, on the FC program counter reaching an address (usually an
+// ELF symbol), or on a bus write seen by the BusSnooper. A scope limits the
+// traced hierarchy, e.g. "i_soc_domain.i_pulp_soc". Outside the window the
+// model runs at untraced speed apart from Verilator's change tracking.
+
+#ifndef TRACE_WINDOW_H
+#define TRACE_WINDOW_H
+
+#include "Vpulpissimo.h"
+#include "bus_snooper.h"
+#include "sim_monitor.h"
+#include "tb_console.h"
+#include "tb_hier.h"
+#if defined(TRACE_FST)
+#include "verilated_fst_c.h"
+#define TB_TRACE
+typedef VerilatedFstC TraceFile;
+#define TRACE_FILE_EXT ".fst"
+#elif defined(TRACE_VCD)
+#include "verilated_vcd_c.h"
+#define TB_TRACE
+typedef VerilatedVcdC TraceFile;
+#define TRACE_FILE_EXT ".vcd"
+#else
+#define TRACE_FILE_EXT ".vcd"
+#endif
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+class TraceWindow : public SimMonitor {
+public:
+    static const uint64_t NEVER = UINT64_MAX;
+
+    explicit TraceWindow(Vpulpissimo* top)
+        : top_(top), file_(nullptr), depth_(99), active_(false), done_(false),
+          start_cycle_(0), stop_cycle_(NEVER), length_(NEVER), opened_at_(0),
+          start_pc_set_(false), start_pc_(0), stop_pc_set_(false), stop_pc_(0),
+          snooper_(nullptr), start_watch_(-1), stop_watch_(-1) {}
+
+    ~TraceWindow() { close(); }
+
+    // Hierarchy to trace, relative to the pulpissimo top ("" = everything)
+    void set_scope(const std::string& scope) { scope_ = scope; }
+    void set_depth(int depth) { depth_ = depth; }
+
+    // Window triggers. Without any start trigger the window opens at cycle 0.
+    void start_at_cycle(uint64_t cycle) { start_cycle_ = cycle; }
+    void stop_at_cycle(uint64_t cycle) { stop_cycle_ = cycle; }
+    void set_length(uint64_t cycles) { length_ = cycles; }
+    void start_at_pc(uint32_t pc) { start_pc_set_ = true; start_pc_ = pc; start_cycle_ = NEVER; }
+    void stop_at_pc(uint32_t pc) { stop_pc_set_ = true; stop_pc_ = pc; }
+    void start_on_write(const BusSnooper* snooper, int watch) {
+        snooper_ = snooper;
+        start_watch_ = watch;
+        start_cycle_ = NEVER;
+    }
+    void stop_on_write(const BusSnooper* snooper, int watch) {
+        snooper_ = snooper;
+        stop_watch_ = watch;
+    }
+
+    // Create the trace file. Must be called before the first eval().
+    bool open(const std::string& filename) {
+#ifdef TB_TRACE
+        top_->contextp()->traceEverOn(true);
+        file_ = new TraceFile;
+        if (!scope_.empty()) {
+            file_->dumpvars(depth_, scope_.compare(0, 4, "TOP.") == 0 ? scope_ : "TOP.pulpissimo." + scope_);
+        }
+        top_->trace(file_, depth_);
+        file_->open(filename.c_str());
+        if (!file_->isOpen()) {
+            delete file_;
+            file_ = nullptr;
+            return false;
+        }
+        active_ = start_cycle_ == 0;
+        return true;
+#else
+        (void)filename;
+        return false;
+#endif
+    }
+
+    bool enabled() const { return file_ != nullptr; }
+    bool active() const { return active_; }
+
+    // Write the current model state if the window is open
+    void dump(uint64_t time_ps) {
+#ifdef TB_TRACE
+        if (active_) file_->dump(time_ps);
+#else
+        (void)time_ps;
+#endif
+    }
+
+    void sample(uint64_t cycle) override {
+        if (!file_ || done_) return;
+        if (!active_) {
+            if (cycle >= start_cycle_ ||
+                (start_pc_set_ && TB_FC_CORE_SIG(top_, pc_id) == start_pc_) ||
+                (start_watch_ >= 0 && snooper_->get_watch(start_watch_).written)) {
+                active_ = true;
+                opened_at_ = cycle;
+                tb_out() << "Trace window opened at cycle " << cycle << std::endl;
+            }
+            return;
+        }
+        if (cycle >= stop_cycle_ || cycle - opened_at_ >= length_ ||
+            (stop_pc_set_ && TB_FC_CORE_SIG(top_, pc_id) == stop_pc_) ||
+            (stop_watch_ >= 0 && snooper_->get_watch(stop_watch_).written)) {
+            active_ = false;
+            done_ = true;
+#ifdef TB_TRACE
+            file_->flush();
+#endif
+            tb_out() << "Trace window closed at cycle " << cycle << std::endl;
+        }
+    }
+
+    void close() {
+#ifdef TB_TRACE
+        if (file_) {
+            file_->close();
+            delete file_;
+            file_ = nullptr;
+        }
+#endif
+    }
+
+private:
+    Vpulpissimo* top_;
+#ifdef TB_TRACE
+    TraceFile* file_;
+#else
+    void* file_;
+#endif
+    std::string scope_;
+    int depth_;
+    bool active_;
+    bool done_;
+    uint64_t start_cycle_;
+    uint64_t stop_cycle_;
+    uint64_t length_;
+    uint64_t opened_at_;
+    bool start_pc_set_;
+    uint32_t start_pc_;
+    bool stop_pc_set_;
+    uint32_t stop_pc_;
+    const BusSnooper* snooper_;
+    int start_watch_;
+    int stop_watch_;
+};
+
+#endif // TRACE_WINDOW_H
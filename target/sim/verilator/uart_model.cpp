@@ -0,0 +1,160 @@
+// Copyright 2025 Custom IP Integration
+// UART console attached to the Verilated pulpissimo.
+
+#include "uart_model.h"
+#include "tb_console.h"
+#include "tb_hier.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <iostream>
+#include <type_traits>
+
+UartModel::UartModel(Vpulpissimo* top, double cycles_per_bit, int rx_pad)
+    : top_(top), bit_fx_((uint64_t)(cycles_per_bit * (1 << FRAC_BITS))), rx_pad_(rx_pad),
+      tx_state_(TX_IDLE), tx_prev_(true), tx_next_fx_(0), tx_bit_(0), tx_shift_(0),
+      out_(stdout), out_owned_(false),
+      in_fd_(-1), in_pty_(false), next_poll_(0), rx_bit_(-1), rx_frame_(0), rx_next_fx_(0),
+      tx_bytes_(0), rx_bytes_(0), framing_errors_(0) {
+    set_rx(true);
+}
+
+UartModel::~UartModel() {
+    if (out_owned_) fclose(out_);
+    if (in_fd_ > 0) close(in_fd_);
+}
+
+bool UartModel::open_output(const std::string& target) {
+    if (target.empty() || target == "-") return true;
+    FILE* f = fopen(target.c_str(), "wb");
+    if (!f) return false;
+    out_ = f;
+    out_owned_ = true;
+    return true;
+}
+
+bool UartModel::open_input(const std::string& source) {
+    if (source == "stdin") {
+        in_fd_ = STDIN_FILENO;
+    } else if (source == "pty") {
+        in_fd_ = posix_openpt(O_RDWR | O_NOCTTY);
+        if (in_fd_ < 0 || grantpt(in_fd_) != 0 || unlockpt(in_fd_) != 0) return false;
+        // Raw mode: bytes pass through untouched (SREC uploads, zForth)
+        struct termios tio;
+        if (tcgetattr(in_fd_, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(in_fd_, TCSANOW, &tio);
+        }
+        tb_out() << "UART pty: " << ptsname(in_fd_) << std::endl;
+        in_pty_ = true;
+    } else {
+        in_fd_ = open(source.c_str(), O_RDONLY);
+        if (in_fd_ < 0) return false;
+    }
+    return true;
+}
+
+void UartModel::set_rx(bool level) {
+    auto& pads = TB_PORT_PAD_IO(top_);
+    typedef typename std::remove_reference<decltype(pads)>::type PadWord;
+    PadWord bit = (PadWord)1 << rx_pad_;
+    pads = level ? (pads | bit) : (pads & ~bit);
+}
+
+void UartModel::sample(uint64_t cycle) {
+    decode_tx(cycle);
+    if (in_fd_ >= 0 || rx_bit_ >= 0 || !rx_queue_.empty()) drive_rx(cycle);
+}
+
+// Sample each bit in its middle; a start bit shorter than half a bit is a glitch
+void UartModel::decode_tx(uint64_t cycle) {
+    bool line = TB_UART_TX(top_);
+    if (tx_state_ == TX_IDLE) {
+        if (tx_prev_ && !line) {
+            tx_state_ = TX_START;
+            tx_next_fx_ = (cycle << FRAC_BITS) + bit_fx_ / 2;
+        }
+        tx_prev_ = line;
+        return;
+    }
+    tx_prev_ = line;
+    if ((cycle << FRAC_BITS) < tx_next_fx_) return;
+    tx_next_fx_ += bit_fx_;
+
+    switch (tx_state_) {
+    case TX_START:
+        if (line) {
+            tx_state_ = TX_IDLE;
+        } else {
+            tx_state_ = TX_DATA;
+            tx_bit_ = 0;
+            tx_shift_ = 0;
+        }
+        break;
+    case TX_DATA:
+        tx_shift_ |= (uint8_t)line << tx_bit_;
+        if (++tx_bit_ == 8) tx_state_ = TX_STOP;
+        break;
+    case TX_STOP:
+        if (line) {
+            fputc(tx_shift_, out_);
+            if (tx_shift_ == '\n') fflush(out_);
+            tx_bytes_++;
+        } else {
+            framing_errors_++;
+        }
+        tx_state_ = TX_IDLE;
+        break;
+    default:
+        break;
+    }
+}
+
+void UartModel::drive_rx(uint64_t cycle) {
+    if (rx_bit_ < 0) {
+        if (rx_queue_.empty()) {
+            if (cycle < next_poll_) return;
+            next_poll_ = cycle + POLL_CYCLES;
+            poll_input();
+            if (rx_queue_.empty()) return;
+        }
+        // Start bit, 8 data bits LSB first, stop bit
+        rx_frame_ = (uint16_t)(0x200 | (rx_queue_.front() << 1));
+        rx_queue_.pop_front();
+        rx_bit_ = 0;
+        rx_next_fx_ = cycle << FRAC_BITS;
+    }
+    if ((cycle << FRAC_BITS) < rx_next_fx_) return;
+    rx_next_fx_ += bit_fx_;
+    if (rx_bit_ == 10) {
+        rx_bit_ = -1;
+        rx_bytes_++;
+        return;
+    }
+    set_rx((rx_frame_ >> rx_bit_) & 1);
+    rx_bit_++;
+}
+
+void UartModel::poll_input() {
+    struct pollfd p = {in_fd_, POLLIN, 0};
+    if (poll(&p, 1, 0) <= 0) return;
+    uint8_t buf[256];
+    ssize_t n = read(in_fd_, buf, sizeof(buf));
+    if (n <= 0) {
+        // A pty reports EIO while no terminal is attached; keep waiting for one
+        if (in_pty_) return;
+        // End of the file or of stdin
+        if (in_fd_ != STDIN_FILENO) close(in_fd_);
+        in_fd_ = -1;
+        return;
+    }
+    rx_queue_.insert(rx_queue_.end(), buf, buf + n);
+}
+
+uint64_t UartModel::next_event(uint64_t cycle) const {
+    if (tx_state_ != TX_IDLE || rx_bit_ >= 0 || !rx_queue_.empty()) return cycle;
+    if (in_fd_ >= 0) return next_poll_ > cycle ? next_poll_ : cycle;
+    return UINT64_MAX;
+}
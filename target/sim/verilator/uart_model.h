@@ -0,0 +1,84 @@
+// Copyright 2025 Custom IP Integration
+// UART console attached to the Verilated pulpissimo.
+//
+// TX is decoded from the uDMA UART output before the pad mux (s_uart_to_pad),
+// so it works whatever pad firmware routes it to. RX is driven onto one bit of
+// the pad_io port (PAD_GPIO01 by default, as in the bootcode Makefile).
+//
+// Bit timing is kept in 1/65536 main clock cycles, so any baud rate works as
+// long as a bit lasts a few cycles. Outside a frame the per-cycle cost is a
+// single signal read, which keeps multi-Mbaud consoles cheap.
+//
+// Input comes from stdin, a pseudo-terminal (for a terminal emulator or a
+// host-side SREC uploader) or a file, and is polled every POLL_CYCLES.
+
+#ifndef UART_MODEL_H
+#define UART_MODEL_H
+
+#include "Vpulpissimo.h"
+#include "sim_monitor.h"
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+
+class UartModel : public SimMonitor {
+public:
+    static const uint64_t POLL_CYCLES = 1024;
+    static const uint64_t FRAC_BITS = 16;
+
+    UartModel(Vpulpissimo* top, double cycles_per_bit, int rx_pad);
+    ~UartModel();
+
+    // Where decoded TX bytes go: "" or "-" for stdout, else a file name
+    bool open_output(const std::string& target);
+
+    // Where RX bytes come from: "stdin", "pty" or a file name
+    bool open_input(const std::string& source);
+
+    void sample(uint64_t cycle) override;
+
+    // Earliest cycle at which the UART needs the model to be evaluated. Used
+    // to bound idle fast-forward; UINT64_MAX when nothing is pending.
+    uint64_t next_event(uint64_t cycle) const;
+
+    uint64_t tx_bytes() const { return tx_bytes_; }
+    uint64_t rx_bytes() const { return rx_bytes_; }
+    uint64_t framing_errors() const { return framing_errors_; }
+
+private:
+    enum TxState { TX_IDLE, TX_START, TX_DATA, TX_STOP };
+
+    void decode_tx(uint64_t cycle);
+    void drive_rx(uint64_t cycle);
+    void poll_input();
+    void set_rx(bool level);
+
+    Vpulpissimo* top_;
+    uint64_t bit_fx_;          // Cycles per bit, fixed point
+    int rx_pad_;
+
+    // TX decoder
+    TxState tx_state_;
+    bool tx_prev_;
+    uint64_t tx_next_fx_;      // Next sample point, fixed point cycles
+    int tx_bit_;
+    uint8_t tx_shift_;
+    FILE* out_;
+    bool out_owned_;
+
+    // RX driver
+    int in_fd_;
+    bool in_pty_;
+    uint64_t next_poll_;
+    std::deque<uint8_t> rx_queue_;
+    int rx_bit_;               // -1 idle, 0 start, 1..8 data, 9 stop
+    uint16_t rx_frame_;
+    uint64_t rx_next_fx_;
+
+    uint64_t tx_bytes_;
+    uint64_t rx_bytes_;
+    uint64_t framing_errors_;
+};
+
+#endif // UART_MODEL_H